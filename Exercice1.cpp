@@ -2,44 +2,27 @@
 #include <vector>
 #include <string>
 #include <cassert>
+#include <chrono>
+#include "achash.h"
+#include "ca_simulator.h"
+#include "cellular_automaton.h"
+#include "corpus.h"
+#include "hashlife.h"
+#include "logger.h"
+#include "spacetime_render.h"
 using namespace std;
 
-// 1.1 - Fonction pour initialiser l'état à partir d'un vecteur de bits
-vector<int> init_state(const vector<int>& initial_bits) {
-    return initial_bits;
+// Représentation de l'état avec 0 et 1
+string state_to_string(const vector<int>& state) {
+    string row(state.size(), '0');
+    for (size_t i = 0; i < state.size(); ++i)
+        if (state[i]) row[i] = '1';
+    return row;
 }
 
-// Fonction pour convertir la règle en tableau binaire
-vector<int> rule_to_binary(int rule_number) {
-    vector<int> rule_bits(8);
-    for (int i = 0; i < 8; ++i) {
-        rule_bits[7 - i] = (rule_number >> i) & 1;
-    }
-    return rule_bits;
-}
-
-// 1.2 - Fonction evolve() : applique une règle sur tout le vecteur
-vector<int> evolve(const vector<int>& state, int rule_number) {
-    int n = state.size();
-    vector<int> next_state(n, 0);
-    vector<int> rule_bits = rule_to_binary(rule_number);
-
-    for (int i = 0; i < n; ++i) {
-        int left   = (i == 0) ? state[n - 1] : state[i - 1];
-        int center = state[i];
-        int right  = (i == n - 1) ? state[0] : state[i + 1];
-
-        int pattern = (left << 2) | (center << 1) | right;
-        next_state[i] = rule_bits[7 - pattern];
-    }
-    return next_state;
-}
-
-// Affichage de l'état avec 0 et 1
-void display_state(const vector<int>& state) {
-    for (int cell : state)
-        cout << (cell ? '1' : '0');
-    cout << endl;
+// Affichage de l'état (libellé + 0/1) via le logger asynchrone : pas de flush par génération
+void display_state(const string& label, const vector<int>& state) {
+    LOG_INFO("{}{}", label, state_to_string(state));
 }
 
 // MÉTHODES DE VÉRIFICATION
@@ -53,13 +36,12 @@ bool verify_known_patterns(int rule) {
     vector<int> current_state = test_state;
     
     cout << "Test 1 - Single 1 pattern:" << endl;
-    cout << "Initial: ";
-    display_state(current_state);
+    display_state("Initial: ", current_state);
     
     // Appliquer une évolution et vérifier les résultats connus
     current_state = evolve(current_state, rule);
-    cout << "Step 1:  ";
-    display_state(current_state);
+    display_state("Step 1:  ", current_state);
+    log_flush();
     
     bool passed = true;
     
@@ -145,21 +127,397 @@ bool verify_against_expected(int rule, const vector<int>& initial,
         current = evolve(current, rule);
         
         if (current != expected_steps[i]) {
-            cout << " Etape " << (i+1) << " incorrecte" << endl;
-            cout << "  Attendu: ";
-            display_state(expected_steps[i]);
-            cout << "  Obtenu:  ";
-            display_state(current);
+            LOG_INFO(" Etape {} incorrecte", i + 1);
+            display_state("  Attendu: ", expected_steps[i]);
+            display_state("  Obtenu:  ", current);
             all_correct = false;
         } else {
-            cout << " Etape " << (i+1) << " correcte: ";
-            display_state(current);
+            display_state(" Etape " + to_string(i + 1) + " correcte: ", current);
         }
     }
+    log_flush();
     
     return all_correct;
 }
 
+// 4. Vérification du moteur générique (cellular_automaton.h) contre evolve()
+bool verify_generic_engine(int rule) {
+    cout << "\n=== Verification du moteur generique ===" << endl;
+    ElementaryAutomaton ca = ElementaryAutomaton::from_number(rule);
+    bool all_correct = true;
+    uint64_t seed = 0x9e3779b97f4a7c15ULL * rule + 1;
+
+    for (size_t n : {3, 7, 64, 100, 1000}) {
+        // Etat pseudo-aleatoire ; lane 0 du mode par lots = meme etat
+        vector<int> current(n);
+        for (int &c : current) {
+            seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+            c = seed & 1;
+        }
+        const vector<int> initial = current;
+        PackedRing packed = PackedRing::from_cells(current), next;
+        vector<uint64_t> lanes(n), lanesNext(n);
+        for (size_t i = 0; i < n; ++i) lanes[i] = current[i];
+
+        for (int step = 0; step < 10 && all_correct; ++step) {
+            current = evolve(current, rule);
+            ca.step(packed, next);
+            swap(packed, next);
+            ca.step_lanes(lanes.data(), lanesNext.data(), n);
+            swap(lanes, lanesNext);
+            for (size_t i = 0; i < n; ++i)
+                if ((int)(lanes[i] & 1) != current[i]) all_correct = false;
+            if (packed.to_cells() != current) all_correct = false;
+        }
+        // Regle additive : l'etat doit aussi egaler le saut direct en O(n log t)
+        AdditiveRule<1> additive = AdditiveRule<1>::detect(ca);
+        if (additive.valid() && additive.jump(PackedRing::from_cells(initial), 10) != packed) all_correct = false;
+        cout << " " << n << " cellules, 10 etapes : " << (all_correct ? "identique" : "DIFFERENT") << endl;
+    }
+    return all_correct;
+}
+
+// ==================== MODE RAYON r (moteur generique) ====================
+
+// Regle : nombre decimal, hexadecimal (0x..., jusqu'a 128 bits pour r = 3)
+// ou "t<code>" pour une regle totalistique
+template <int Radius>
+bool parse_rule(const string &text, CellularAutomaton<Radius> &ca) {
+    typedef CellularAutomaton<Radius> CA;
+    try {
+        if (!text.empty() && text[0] == 't') {
+            ca = CA::totalistic(static_cast<uint32_t>(stoul(text.substr(1), nullptr, 0)));
+            return true;
+        }
+        typename CA::RuleTable table{};
+        if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+            string digits = text.substr(2);
+            if (digits.size() * 4 > CA::rule_width + 3) return false;
+            for (size_t k = 0; k < digits.size(); ++k) {
+                size_t nibble = digits.size() - 1 - k;   // nibble 0 = poids faible
+                uint64_t v = stoul(digits.substr(k, 1), nullptr, 16);
+                table[nibble / 16] |= v << (4 * (nibble % 16));
+            }
+        } else {
+            table[0] = stoull(text);
+        }
+        if constexpr (CA::rule_width < 64) {
+            if ((table[0] >> CA::rule_width) != 0) return false;
+        }
+        ca = CA(table);
+        return true;
+    } catch (const exception &) {
+        return false;
+    }
+}
+
+// Diagramme espace-temps ecrit en flux dans un fichier (PBM / PGM / PNG)
+struct RenderOptions {
+    string path;                          // vide : affichage texte
+    size_t block = 1;                     // sous-echantillonnage par blocs block x block
+    SpaceTimeRenderer::Pooling pooling = SpaceTimeRenderer::Pooling::MAX;
+};
+
+template <int Radius>
+int render_radius(const CellularAutomaton<Radius> &ca, size_t cells, size_t generations, const RenderOptions &opt) {
+    SpaceTimeRenderer renderer(opt.path, cells, generations + 1, opt.block, opt.pooling);
+    if (!renderer.ok()) {
+        cerr << "Impossible d'ecrire " << opt.path << endl;
+        return 1;
+    }
+    cout << "Rendu " << renderer.width() << " x " << renderer.height() << " pixels ("
+         << (opt.pooling == SpaceTimeRenderer::Pooling::MAX ? "max" : "moyenne") << " sur des blocs de "
+         << opt.block << " x " << opt.block << ") -> " << opt.path << endl;
+
+    auto start = chrono::steady_clock::now();
+    PackedRing state(cells), next;
+    state.set(cells / 2, true);
+    renderer.push(state);
+    for (size_t g = 0; g < generations; ++g) {
+        ca.step(state, next);
+        swap(state, next);
+        renderer.push(state);
+    }
+    bool ok = renderer.finish();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Duree: " << seconds << " s (" << static_cast<double>(cells) * (generations + 1) / seconds / 1e9
+         << " milliards de cellules/s)" << endl;
+    if (!ok) cerr << "Erreur d'ecriture dans " << opt.path << endl;
+    return ok ? 0 : 1;
+}
+
+template <int Radius>
+int run_radius(const string &ruleText, size_t cells, size_t generations, const RenderOptions &render) {
+    CellularAutomaton<Radius> ca = CellularAutomaton<Radius>::from_number(0);
+    if (!parse_rule(ruleText, ca)) {
+        cerr << "Regle invalide pour r = " << Radius << " : " << ruleText << endl;
+        return 1;
+    }
+    cout << "=== Automate r = " << Radius << " (" << CellularAutomaton<Radius>::window << " cellules), regle "
+         << ruleText << ", noyau " << ca_kernel_name(ca.kernel()) << " ===" << endl;
+    if (!render.path.empty()) return render_radius(ca, cells, generations, render);
+
+    PackedRing state(cells), next;
+    state.set(cells / 2, true);
+    LOG_INFO("{}", state.to_string('.', '#'));
+    for (size_t g = 0; g < generations; ++g) {
+        ca.step(state, next);
+        swap(state, next);
+        LOG_INFO("{}", state.to_string('.', '#'));
+    }
+    log_flush();
+    return 0;
+}
+
+// Usage : Exercice1 ca <rayon 1..3> <regle | t<code>> [cellules=79] [generations=40] [fichier.pbm|.png] [bloc=1] [max|moy]
+int run_generic(int argc, char **argv) {
+    if (argc < 4) {
+        cerr << "Usage: Exercice1 ca <rayon 1..3> <regle | 0x... | t<code>> [cellules] [generations]"
+             << " [fichier.pbm|.png] [bloc] [max|moy]" << endl;
+        return 1;
+    }
+    int radius = stoi(argv[2]);
+    string ruleText = argv[3];
+    size_t cells = (argc > 4) ? stoul(argv[4]) : 79;
+    size_t generations = (argc > 5) ? stoul(argv[5]) : 40;
+    RenderOptions render;
+    if (argc > 6) render.path = argv[6];
+    if (argc > 7) render.block = max<size_t>(1, stoul(argv[7]));
+    if (argc > 8 && string(argv[8]) == "moy") render.pooling = SpaceTimeRenderer::Pooling::AVERAGE;
+    if (cells == 0) cells = 1;
+    switch (radius) {
+        case 1: return run_radius<1>(ruleText, cells, generations, render);
+        case 2: return run_radius<2>(ruleText, cells, generations, render);
+        case 3: return run_radius<3>(ruleText, cells, generations, render);
+        default:
+            cerr << "Rayon 1 a 3" << endl;
+            return 1;
+    }
+}
+
+// ==================== SIMULATION A GRANDE ECHELLE ====================
+
+struct SimulationOptions {
+    size_t cells = 1000000;
+    size_t generations = 1000;
+    unsigned threads = 0;                 // 0 : tous les coeurs
+    Boundary boundary = Boundary::PERIODIC;
+    bool single_seed = false;             // un seul 1 au centre (sinon aleatoire)
+    string blocking = "auto";             // auto | non | k | km (k generations par passage, m : LUT multi-generations)
+};
+
+template <int Radius>
+int run_simulation(const string &ruleText, const SimulationOptions &opt) {
+    CellularAutomaton<Radius> ca = CellularAutomaton<Radius>::from_number(0);
+    if (!parse_rule(ruleText, ca)) {
+        cerr << "Regle invalide pour r = " << Radius << " : " << ruleText << endl;
+        return 1;
+    }
+
+    PackedRing initial(opt.cells);
+    if (opt.single_seed) {
+        initial.set(opt.cells / 2, true);
+    } else {
+        Xoshiro256 rng(corpus_seed_from_env());
+        for (uint64_t &w : initial.words) w = rng.next();
+        initial.words.back() &= initial.last_mask();
+    }
+
+    ParallelSimulator<Radius> sim(ca, opt.cells, opt.threads, opt.boundary);
+    sim.load(initial);
+    cout << "=== Simulation r = " << Radius << ", regle " << ruleText << " ===" << endl;
+    cout << "Cellules: " << opt.cells << ", generations: " << opt.generations << ", bords: "
+         << (opt.boundary == Boundary::PERIODIC ? "periodiques" : "fixes") << ", etat initial: "
+         << (opt.single_seed ? "un seul 1" : "aleatoire") << endl;
+
+    // Regle additive : saut en O(n log t), puis les noyaux generiques sont
+    // verifies contre ce saut si leur calcul reste raisonnable
+    PackedRing jumped;
+    bool additive = sim.uses_additive_jump();
+    if (additive) {
+        sim.run(opt.generations);
+        jumped = sim.state();
+        cout << "Regle additive: saut direct en O(n log t), " << sim.seconds() * 1e3 << " ms" << endl;
+        cout << "Population finale: " << jumped.population() << " / " << opt.cells << endl;
+        if (static_cast<double>(opt.cells) * opt.generations > 2e10) return 0;
+        sim.set_additive_jump(false);
+        sim.load(initial);
+    }
+
+    // Blocage temporel : automatique si l'etat (deux tampons) depasse le L2
+    const size_t l2 = l2_cache_bytes();
+    bool large = 2 * initial.words.size() * sizeof(uint64_t) > l2;
+    // LUT multi-generations : paie meme quand l'etat tient en cache (r = 1 et 2 ;
+    // les regles additives, seul raccourci booleen plus court, sont traitees par le saut)
+    const bool multi_pays = CellularAutomaton<Radius>::multi_steps > 1;
+    if (opt.blocking == "auto") {
+        if (large) sim.tune_blocking();
+        else if (multi_pays) sim.set_blocking({l2 / 32, 16, true});
+    } else if (opt.blocking != "non") {
+        size_t depth = stoul(opt.blocking);
+        bool multi = opt.blocking.back() == 'm';
+        sim.set_blocking({l2 / 32, depth, multi});
+    }
+    cout << "Noyau: " << ca_kernel_name(ca.kernel()) << ", threads: " << sim.thread_count() << endl;
+    if (sim.blocking().depth > 1)
+        cout << "Blocage temporel: tuiles de " << sim.blocking().tile_words << " mots, "
+             << sim.blocking().depth << " generations par passage"
+             << (sim.blocking().multi ? ", LUT multi-generations (" + to_string(CellularAutomaton<Radius>::multi_steps) +
+                                            " generations par consultation)" : "") << endl;
+    else
+        cout << "Blocage temporel: aucun" << endl;
+
+    sim.run(opt.generations);
+    PackedRing final_state = sim.state();
+    cout << "Duree: " << sim.seconds() << " s" << endl;
+    cout << "Debit: " << sim.cell_updates_per_second() / 1e9 << " milliards de cellules/s" << endl;
+    if (sim.sparse_generations())
+        cout << "Evolution creuse: " << sim.sparse_generations() << " generations sur l'intervalle actif"
+             << (sim.is_sparse() ? "" : ", puis calcul complet") << endl;
+    cout << "Population finale: " << final_state.population() << " / " << opt.cells << endl;
+    if (additive) {
+        bool ok = final_state == jumped;
+        cout << "Verification contre le saut additif: " << (ok ? "PASSE" : "ECHOUE") << endl;
+        if (!ok) return 1;
+    }
+    return 0;
+}
+
+// Usage : Exercice1 sim <rayon> <regle> [cellules] [generations] [threads] [periodique|fixe] [aleatoire|centre] [bloc]
+int run_simulation_mode(int argc, char **argv) {
+    if (argc < 4) {
+        cerr << "Usage: Exercice1 sim <rayon 1..3> <regle> [cellules=1000000] [generations=1000] [threads]"
+             << " [periodique|fixe] [aleatoire|centre] [bloc: auto|non|k|km]" << endl;
+        return 1;
+    }
+    SimulationOptions opt;
+    int radius = stoi(argv[2]);
+    string ruleText = argv[3];
+    if (argc > 4) opt.cells = static_cast<size_t>(stod(argv[4]));
+    if (argc > 5) opt.generations = static_cast<size_t>(stod(argv[5]));
+    if (argc > 6) opt.threads = static_cast<unsigned>(stoul(argv[6]));
+    if (argc > 7) opt.boundary = (string(argv[7]) == "fixe") ? Boundary::FIXED : Boundary::PERIODIC;
+    if (argc > 8) opt.single_seed = (string(argv[8]) == "centre");
+    if (argc > 9) opt.blocking = argv[9];
+    if (opt.cells == 0) opt.cells = 1;
+    switch (radius) {
+        case 1: return run_simulation<1>(ruleText, opt);
+        case 2: return run_simulation<2>(ruleText, opt);
+        case 3: return run_simulation<3>(ruleText, opt);
+        default:
+            cerr << "Rayon 1 a 3" << endl;
+            return 1;
+    }
+}
+
+// ==================== HASHLIFE ====================
+
+struct HashlifeOptions {
+    uint64_t generations = 1000000000000ULL;
+    bool ring = false;            // anneau aleatoire de 2^log_cells cellules (sinon un seul 1, ligne infinie)
+    int log_cells = 12;
+    size_t window = 79;           // cellules affichees
+    size_t max_nodes = size_t(1) << 18;
+};
+
+// Reference directe (moteur generique) si le calcul reste raisonnable
+bool verify_hashlife(int rule, const HashlifeOptions &opt, const PackedRing &initial, const Hashlife1D &life) {
+    ElementaryAutomaton ca = ElementaryAutomaton::from_number(rule);
+    PackedRing state, next;
+    long long first = 0;
+    Boundary boundary = Boundary::PERIODIC;
+    if (opt.ring) {
+        state = initial;
+    } else {
+        // Segment a bords fixes assez large pour que le cone ne touche pas les bords
+        first = -static_cast<long long>(life.generation()) - 1;
+        state = PackedRing(2 * life.generation() + 3);
+        state.set(static_cast<size_t>(-first), true);
+        boundary = Boundary::FIXED;
+    }
+    for (uint64_t g = 0; g < life.generation(); ++g) {
+        ca.step(state, next, boundary);
+        swap(state, next);
+    }
+    return opt.ring ? life.ring() == state : life.window(first, state.cells) == state;
+}
+
+int run_hashlife(int rule, const HashlifeOptions &opt) {
+    Hashlife1D life(rule, opt.max_nodes);
+    PackedRing initial;
+    if (opt.ring) {
+        initial = PackedRing(size_t(1) << opt.log_cells);
+        Xoshiro256 rng(corpus_seed_from_env());
+        for (uint64_t &w : initial.words) w = rng.next();
+        life.load_ring(initial);
+    } else {
+        initial = PackedRing(1);
+        initial.set(0, true);
+        if (!life.load_line(initial)) {
+            cerr << "Regle " << rule << " : 000 -> 1, le fond de 0 n'est pas stable (utiliser un anneau)" << endl;
+            return 1;
+        }
+    }
+
+    cout << "=== Hashlife, regle " << rule << " ===" << endl;
+    cout << "Univers: " << (opt.ring ? "anneau aleatoire de 2^" + to_string(opt.log_cells) + " cellules"
+                                     : string("ligne infinie, un seul 1 en 0")) << endl;
+    auto t0 = chrono::steady_clock::now();
+    bool complete = life.advance(opt.generations);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+    if (!complete)
+        cout << "Borne memoire atteinte (" << opt.max_nodes << " noeuds) : regle trop peu reguliere,"
+             << " arret a la generation " << life.generation() << endl;
+    cout << "Generation: " << life.generation() << " en " << ms << " ms" << endl;
+    cout << "Population: " << life.population() << endl;
+    cout << "Noeuds: " << life.node_count() << ", ramasse-miettes: " << life.collections() << endl;
+
+    long long first = opt.ring ? 0 : -static_cast<long long>(opt.window / 2);
+    cout << life.window(first, opt.window).to_string('.', '#') << endl;
+
+    double direct_cost = static_cast<double>(life.generation()) *
+                         (opt.ring ? static_cast<double>(initial.cells) : 2.0 * life.generation());
+    if (complete && direct_cost <= 2e9) {
+        bool ok = verify_hashlife(rule, opt, initial, life);
+        cout << "Verification (moteur direct): " << (ok ? "PASSE" : "ECHOUE") << endl;
+        if (!ok) return 1;
+    }
+    return complete ? 0 : 1;
+}
+
+// Usage : Exercice1 hashlife <regle 0..255> [generations=1e12] [centre | anneau <log2 cellules>] [fenetre] [noeuds max]
+int run_hashlife_mode(int argc, char **argv) {
+    if (argc < 3) {
+        cerr << "Usage: Exercice1 hashlife <regle 0..255> [generations=1e12] [centre | anneau <log2 cellules=12>]"
+             << " [fenetre=79] [noeuds max=262144]" << endl;
+        return 1;
+    }
+    int rule = stoi(argv[2]);
+    if (rule < 0 || rule > 255) {
+        cerr << "Regle 0 a 255" << endl;
+        return 1;
+    }
+    HashlifeOptions opt;
+    int arg = 3;
+    if (argc > arg) opt.generations = static_cast<uint64_t>(stod(argv[arg++]));
+    if (argc > arg) {
+        opt.ring = (string(argv[arg++]) == "anneau");
+        if (opt.ring && argc > arg) opt.log_cells = stoi(argv[arg++]);
+    }
+    if (argc > arg) opt.window = stoul(argv[arg++]);
+    if (argc > arg) opt.max_nodes = static_cast<size_t>(stod(argv[arg++]));
+    if (opt.log_cells < 6 || opt.log_cells > 30) {
+        cerr << "Anneau de 2^6 a 2^30 cellules" << endl;
+        return 1;
+    }
+    if (opt.generations >= (1ULL << 60)) {
+        cerr << "Au plus 2^60 generations" << endl;
+        return 1;
+    }
+    return run_hashlife(rule, opt);
+}
+
 // Fonction pour afficher le menu
 void display_menu() {
     cout << "\n=== Automate cellulaire 1D ===" << endl;
@@ -171,7 +529,11 @@ void display_menu() {
     cout << "Votre choix : ";
 }
 
-int main() {
+int main(int argc, char **argv) {
+    if (argc > 1 && string(argv[1]) == "ca") return run_generic(argc, argv);
+    if (argc > 1 && string(argv[1]) == "sim") return run_simulation_mode(argc, argv);
+    if (argc > 1 && string(argv[1]) == "hashlife") return run_hashlife_mode(argc, argv);
+
     int rule;
     
     do {
@@ -197,13 +559,15 @@ int main() {
         
         bool test1 = verify_known_patterns(rule);
         bool test2 = verify_truth_table(rule);
+        bool test3 = verify_generic_engine(rule);
         
         // Résultats des vérifications
         cout << "\n*** RESULTATS DES VERIFICATIONS ***" << endl;
         cout << "Test motifs connus: " << (test1 ? "PASSE" : "ECHOUE") << endl;
         cout << "Test table verite: " << (test2 ? "PASSE " : "ECHOUE") << endl;
+        cout << "Test moteur generique: " << (test3 ? "PASSE" : "ECHOUE") << endl;
         
-        if (test1 && test2) {
+        if (test1 && test2 && test3) {
             cout << "\n L'automate reproduit correctement la Rule " << rule << " !" << endl;
         } else {
             cout << "\n Problemes detectes avec la Rule " << rule << " !" << endl;
@@ -211,14 +575,13 @@ int main() {
         
         // Simulation normale
         cout << "\n=== Simulation Rule " << rule << " ===" << endl;
-        cout << "Initial: ";
-        display_state(state);
+        display_state("Initial: ", state);
         
         for (int step = 1; step <= 10; ++step) {
             state = evolve(state, rule);
-            cout << "Step " << step << ":  ";
-            display_state(state);
+            display_state("Step " + to_string(step) + ":  ", state);
         }
+        log_flush();
         
         cout << "\nAppuyez sur Entree pour continuer...";
         cin.ignore();
@@ -4,387 +4,239 @@
 #include <sstream>
 #include <iomanip>
 #include <string>
-#include <random>
 #include <chrono>
 #include <cmath>
 #include <algorithm>
 #include <iomanip>
-#include <functional>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "achash.h"
+#include "corpus.h"
+#include "digest_stats.h"
+#include "sequential.h"
+#include "trace.h"
 
 using namespace std;
 using namespace std::chrono;
 
-// Version améliorée avec règle dynamique adaptative et voisinage variable
-string ac_hash_plus(const string& input, uint32_t base_rule, size_t steps) {
-    // 1. Conversion du texte en bits avec permutation
-    vector<bool> input_bits;
-    for (char c : input) {
-        bitset<8> char_bits(c);
-        // Permutation des bits pour plus de diffusion
-        vector<int> permutation = {2, 5, 0, 7, 1, 4, 3, 6};
-        for (int idx : permutation) {
-            input_bits.push_back(char_bits[idx]);
-        }
-    }
-
-    // 2. Padding amélioré
-    size_t original_size = input_bits.size();
-    input_bits.push_back(1);
-    
-    // Ajout de sel basé sur la longueur du message
-    size_t salt = original_size * 37;
-    for (int i = 0; i < 32; ++i) {
-        input_bits.push_back((salt >> i) & 1);
-    }
-    
-    while ((input_bits.size() + 64) % 512 != 0) {
-        input_bits.push_back(0);
-    }
-    
-    bitset<64> size_bits(original_size);
-    for (int i = 63; i >= 0; --i) {
-        input_bits.push_back(size_bits[i]);
-    }
-
-    // 3. État étendu à 512 bits pour plus de sécurité
-    vector<bool> state(512, false);
-
-    // 4. Absorption avec voisinage variable
-    for (size_t block = 0; block < input_bits.size(); block += 512) {
-        // XOR du bloc dans l'état avec rotation
-        for (size_t i = 0; i < 512 && (block + i) < input_bits.size(); ++i) {
-            size_t rotated_pos = (i * 3) % 512;
-            state[rotated_pos] = state[rotated_pos] != input_bits[block + i];
-        }
+// ==================== REGISTRE DES VARIANTES ====================
+//
+// Chaque variante est un type (nom, parametres, empreinte scalaire et,
+// si disponible, empreinte par lots de 64 messages). La liste des variantes
+// comparees est fixee a la compilation par HashRegistry<...> : les appels
+// sont directs (pas de std::function) et le pilote choisit le noyau par
+// lots avec if constexpr.
+
+const size_t HASH_BATCH = 64;
+
+template <uint32_t Rule, size_t Steps = 10>
+struct OriginalVariant {
+    static constexpr uint32_t rule = Rule;
+    static constexpr size_t steps = Steps;
+    static constexpr bool batched = true;
+    static string name() { return "Original Rule " + to_string(Rule); }
+    static Digest256 hash(const string &m) { return ac_hash_digest(m, Rule, Steps); }
+    static void batch(const string *in, size_t n, Digest256 *out) { ac_hash_digest_batch(in, n, Rule, Steps, out); }
+};
 
-        // Application de l'automate avec règle dynamique adaptative
-        for (size_t step = 0; step < steps; ++step) {
-            vector<bool> new_state(512, false);
-            
-            // Règle dynamique basée sur l'état actuel
-            uint32_t state_hash = 0;
-            for (size_t j = 0; j < 32; ++j) {
-                if (state[j * 16]) state_hash |= (1 << j);
-            }
-            
-            uint32_t dynamic_rule = (base_rule + step * 37 + block + state_hash) % 256;
-            
-            // Voisinage variable (3, 5 ou 7 cellules) basé sur l'étape
-            int neighborhood_size = 3 + (step % 3) * 2; // 3, 5 ou 7
-            
-            for (size_t i = 0; i < 512; ++i) {
-                int pattern = 0;
-                int bits_to_take = neighborhood_size;
-                
-                // Construction du motif selon la taille du voisinage
-                for (int j = 0; j < bits_to_take; ++j) {
-                    int offset = j - bits_to_take / 2;
-                    size_t pos = (i + offset + 512) % 512;
-                    pattern = (pattern << 1) | state[pos];
-                }
-                
-                // Application de la règle
-                new_state[i] = (dynamic_rule >> (pattern % 8)) & 1;
-            }
+template <uint32_t Rule, size_t Steps = 10>
+struct PlusVariant {
+    static constexpr uint32_t rule = Rule;
+    static constexpr size_t steps = Steps;
+    static constexpr bool batched = true;
+    static string name() { return "AC-Hash+ Rule " + to_string(Rule); }
+    static Digest256 hash(const string &m) { return ac_hash_plus_digest(m, Rule, Steps); }
+    static void batch(const string *in, size_t n, Digest256 *out) { ac_hash_plus_digest_batch(in, n, Rule, Steps, out); }
+};
 
-            // Mélange additionnel amélioré
-            for (size_t i = 0; i < 512; ++i) {
-                size_t mix_pos1 = (i * 7 + step * 13) % 512;
-                size_t mix_pos2 = (i * 11 + step * 17) % 512;
-                new_state[i] = new_state[i] != state[mix_pos1] != state[mix_pos2];
-            }
+template <class... Variants>
+struct HashRegistry {
+    static constexpr size_t size = sizeof...(Variants);
 
-            state = new_state;
-        }
+    // f(V{}, index) pour chaque variante, dans l'ordre de la liste
+    template <class F>
+    static void for_each(F &&f) {
+        size_t index = 0;
+        (f(Variants{}, index++), ...);
     }
 
-    // 5. Finalisation étendue avec plus d'étapes
-    for (int k = 0; k < 20; ++k) {
-        vector<bool> new_state(512);
-        for (size_t i = 0; i < 512; ++i) {
-            // Voisinage de 5 cellules pour la finalisation
-            int left2 = state[(i + 510) % 512];
-            int left1 = state[(i + 511) % 512];
-            int center = state[i];
-            int right1 = state[(i + 1) % 512];
-            int right2 = state[(i + 2) % 512];
-            int pattern = (left2 << 4) | (left1 << 3) | (center << 2) | (right1 << 1) | right2;
-            
-            new_state[i] = ((base_rule >> (pattern % 32)) & 1) ^ state[(i * 7 + k * 19) % 512];
-        }
-        state = new_state;
-    }
-
-    // 6. Compression de 512 bits à 256 bits pour la sortie
-    vector<bool> final_state(256, false);
-    for (size_t i = 0; i < 256; ++i) {
-        final_state[i] = state[i] != state[i + 256];
+    // f(V{}) pour la variante numero index
+    template <class F>
+    static void visit(size_t index, F &&f) {
+        size_t i = 0;
+        ((i++ == index ? f(Variants{}) : void()), ...);
     }
+};
 
-    // 7. Conversion en hexadecimal
-    stringstream hash_ss;
-    hash_ss << hex << setfill('0');
-    for (size_t i = 0; i < 256; i += 8) {
-        uint8_t byte = 0;
-        for (size_t j = 0; j < 8; ++j) {
-            byte = (byte << 1) | final_state[i + j];
-        }
-        hash_ss << setw(2) << (int)byte;
+using ComparedVariants = HashRegistry<
+    OriginalVariant<30>, OriginalVariant<90>, OriginalVariant<110>,
+    PlusVariant<30>, PlusVariant<90>, PlusVariant<110>>;
+
+// Empreintes de n messages : noyau par lots si la variante en a un
+template <class V>
+void hash_many(const string *in, size_t n, Digest256 *out) {
+    if constexpr (V::batched) {
+        for (size_t first = 0; first < n; first += HASH_BATCH)
+            V::batch(in + first, min(HASH_BATCH, n - first), out + first);
+    } else {
+        for (size_t i = 0; i < n; ++i) out[i] = V::hash(in[i]);
     }
-
-    return hash_ss.str();
 }
 
-// Fonctions de test communes
-string generate_random_message(size_t length) {
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> dis(32, 126);
-    
-    string message;
-    for (size_t i = 0; i < length; ++i) {
-        message += static_cast<char>(dis(gen));
-    }
-    return message;
-}
+// ==================== CORPUS COMMUN ====================
 
-string flip_random_bit(const string& message) {
-    if (message.empty()) return message;
-    
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> byte_dis(0, message.length() - 1);
-    uniform_int_distribution<> bit_dis(0, 7);
-    
-    string modified = message;
-    size_t byte_pos = byte_dis(gen);
-    int bit_pos = bit_dis(gen);
-    
-    modified[byte_pos] ^= (1 << bit_pos);
-    return modified;
-}
+// Messages generes une seule fois et lus par toutes les variantes
+struct TestCorpus {
+    vector<string> originals, modified;   // paires avalanche (flux 0)
+    vector<string> distribution;          // flux 1
+    vector<string> timing;                // flux 2
+};
 
-double count_bit_difference(const string& hash1, const string& hash2) {
-    if (hash1.length() != hash2.length()) return -1;
-    
-    int total_bits = hash1.length() * 4;
-    int diff_count = 0;
-    
-    for (size_t i = 0; i < hash1.length(); ++i) {
-        int val1, val2;
-        stringstream ss1, ss2;
-        ss1 << hex << hash1[i];
-        ss2 << hex << hash2[i];
-        ss1 >> val1;
-        ss2 >> val2;
-        
-        bitset<4> bits1(val1);
-        bitset<4> bits2(val2);
-        bitset<4> diff = bits1 ^ bits2;
-        diff_count += diff.count();
+TestCorpus make_test_corpus(size_t quality_samples, size_t timing_hashes) {
+    TRACE_SCOPE_ARG("make_test_corpus", "num_tests", quality_samples);
+    TestCorpus tc;
+    MessageCorpus corpus(corpus_kind_from_env(), 64, corpus_seed_from_env(), 0);
+    for (size_t i = 0; i < quality_samples; ++i) {
+        tc.originals.emplace_back(corpus.next());
+        tc.modified.push_back(tc.originals.back());
+        flip_random_bit(tc.modified.back(), corpus.rng());
     }
-    
-    return (diff_count * 100.0) / total_bits;
+    MessageCorpus distributionCorpus(corpus_kind_from_env(), 64, corpus_seed_from_env(), 1);
+    MessageCorpus timingCorpus(corpus_kind_from_env(), 64, corpus_seed_from_env(), 2);
+    for (size_t i = 0; i < quality_samples; ++i) tc.distribution.emplace_back(distributionCorpus.next());
+    for (size_t i = 0; i < timing_hashes; ++i) tc.timing.emplace_back(timingCorpus.next());
+    return tc;
 }
 
-// Tests pour une fonction de hachage donnée
+// ==================== TESTS ====================
+
 struct TestResults {
+    string name;
     double avalanche_effect;
     double bit_distribution;
+    string avalanche_interval;      // moyenne +/- demi-largeur (99%), echantillons, decision
+    string distribution_interval;
+    double avalanche_half;          // demi-largeurs des intervalles (99%)
+    double distribution_half;
     double execution_time_ms;
     string test_hash;
 };
 
-TestResults test_hash_function(const string& hash_name, 
-                              function<string(const string&)> hash_func,
-                              size_t num_tests = 1000) {
-    
-    cout << "Testing " << hash_name << "..." << endl;
-    
+// Avalanche et distribution (sequentiels : au plus num_tests observations,
+// arret sur la largeur d'intervalle), calcules par paquets de HASH_BATCH messages
+template <class V>
+TestResults test_hash_quality(const TestCorpus &tc, size_t num_tests) {
+    TRACE_SCOPE_ARG("test_hash_quality", "rule", V::rule);
     TestResults results;
-    
-    // Test d'effet avalanche
-    double total_avalanche = 0.0;
-    int avalanche_tests = 0;
-    
-    for (size_t i = 0; i < num_tests; ++i) {
-        string original = generate_random_message(64);
-        string modified = flip_random_bit(original);
-        
-        string hash_orig = hash_func(original);
-        string hash_mod = hash_func(modified);
-        
-        double diff = count_bit_difference(hash_orig, hash_mod);
-        if (diff >= 0) {
-            total_avalanche += diff;
-            avalanche_tests++;
-        }
-        
-        if (i == 0) {
-            results.test_hash = hash_orig.substr(0, 16) + "..."; // Premier hash pour exemple
-        }
+    results.name = V::name();
+
+    SequentialConfig sequential = comparison_config(num_tests);
+    SequentialEstimator avalanche(sequential);
+    Digest256 h0[HASH_BATCH], h1[HASH_BATCH];
+
+    for (size_t first = 0; first < num_tests && !avalanche.done(); first += HASH_BATCH) {
+        size_t count = min(HASH_BATCH, num_tests - first);
+        hash_many<V>(&tc.originals[first], count, h0);
+        hash_many<V>(&tc.modified[first], count, h1);
+        if (first == 0) results.test_hash = digest_to_hex(h0[0]).substr(0, 16) + "..."; // Premier hash pour exemple
+        for (size_t i = 0; i < count && !avalanche.done(); ++i)
+            avalanche.add(digest_hamming(h0[i], h1[i]) * 100.0 / DIGEST_BITS);
     }
-    results.avalanche_effect = total_avalanche / avalanche_tests;
-    
-    // Test de distribution des bits
-    size_t total_bits = 0;
-    size_t total_ones = 0;
-    
-    for (size_t i = 0; i < num_tests; ++i) {
-        string message = generate_random_message(64);
-        string hash = hash_func(message);
-        
-        for (char c : hash) {
-            int value;
-            stringstream ss;
-            ss << hex << c;
-            ss >> value;
-            bitset<4> nibble(value);
-            for (int j = 0; j < 4; ++j) {
-                if (nibble[j]) total_ones++;
-            }
-        }
-        total_bits += hash.length() * 4;
-    }
-    results.bit_distribution = (total_ones * 100.0) / total_bits;
-    
-    // Test de performance
-    vector<string> test_messages;
-    for (size_t i = 0; i < num_tests; ++i) {
-        test_messages.push_back(generate_random_message(64));
+    results.avalanche_effect = avalanche.mean();
+    results.avalanche_interval = avalanche.summary();
+    results.avalanche_half = avalanche.halfWidth();
+
+    // Distribution des bits (une observation = % de 1 d'une empreinte)
+    SequentialEstimator distribution(sequential);
+    for (size_t first = 0; first < num_tests && !distribution.done(); first += HASH_BATCH) {
+        size_t count = min(HASH_BATCH, num_tests - first);
+        hash_many<V>(&tc.distribution[first], count, h0);
+        for (size_t i = 0; i < count && !distribution.done(); ++i)
+            distribution.add(digest_ones(h0[i]) * 100.0 / DIGEST_BITS);
     }
-    
-    auto start = high_resolution_clock::now();
-    for (const string& msg : test_messages) {
-        hash_func(msg);
-    }
-    auto end = high_resolution_clock::now();
-    
-    results.execution_time_ms = duration_cast<microseconds>(end - start).count() / 1000.0;
-    
-    cout << " " << hash_name << " completed" << endl;
+    results.bit_distribution = distribution.mean();
+    results.distribution_interval = distribution.summary();
+    results.distribution_half = distribution.halfWidth();
     return results;
 }
 
-// Wrappers pour les différentes versions
-string ac_hash_30(const string& input) {
-    return ac_hash_plus(input, 30, 10);
+// Temps pour num_tests empreintes (noyau par lots si disponible) ; mesure
+// apres les tests paralleles pour ne pas compter la concurrence entre threads
+template <class V>
+double time_hash_function(const TestCorpus &tc) {
+    TRACE_SCOPE_ARG("execution_time", "hashes", tc.timing.size());
+    vector<Digest256> out(tc.timing.size());
+    auto start = high_resolution_clock::now();
+    hash_many<V>(tc.timing.data(), tc.timing.size(), out.data());
+    auto end = high_resolution_clock::now();
+    return duration_cast<microseconds>(end - start).count() / 1000.0;
 }
 
-string ac_hash_90(const string& input) {
-    return ac_hash_plus(input, 90, 10);
+// Score de qualite (sur 100) et sa marge : l'incertitude des deux moyennes,
+// le temps etant pris comme exact
+double quality_score(const TestResults &r) {
+    return 100.0 - (abs(50.0 - r.avalanche_effect) * 10 + abs(50.0 - r.bit_distribution) * 5 + r.execution_time_ms / 10);
 }
 
-string ac_hash_110(const string& input) {
-    return ac_hash_plus(input, 110, 10);
+double quality_margin(const TestResults &r) {
+    return r.avalanche_half * 10 + r.distribution_half * 5;
 }
 
-// Fonction originale pour comparaison (doit être définie)
-string ac_hash_original(const string& input, uint32_t rule, size_t steps) {
-    // Implémentation originale fournie précédemment
-    vector<bool> input_bits;
-    for (char c : input) {
-        bitset<8> char_bits(c);
-        for (int i = 7; i >= 0; --i)
-            input_bits.push_back(char_bits[i]);
-    }
-
-    size_t original_size = input_bits.size();
-    input_bits.push_back(1);
-    while ((input_bits.size() + 64) % 256 != 0)
-        input_bits.push_back(0);
-    
-    bitset<64> size_bits(original_size);
-    for (int i = 63; i >= 0; --i)
-        input_bits.push_back(size_bits[i]);
-
-    vector<bool> state(256, false);
-
-    for (size_t block = 0; block < input_bits.size(); block += 256) {
-        for (size_t i = 0; i < 256 && (block + i) < input_bits.size(); ++i)
-            state[i] = state[i] != input_bits[block + i];
-
-        for (size_t step = 0; step < steps; ++step) {
-            vector<bool> new_state(256, false);
-            uint32_t dynamic_rule = (rule + step * 37 + block) % 256;
-            vector<bool> rule_bits(8);
-            for (int i = 0; i < 8; ++i)
-                rule_bits[7 - i] = (dynamic_rule >> i) & 1;
-
-            for (size_t i = 0; i < 256; ++i) {
-                int left = (i == 0) ? state[255] : state[i - 1];
-                int center = state[i];
-                int right = (i == 255) ? state[0] : state[i + 1];
-                int pattern = (left << 2) | (center << 1) | right;
-                new_state[i] = rule_bits[7 - pattern];
-            }
-
-            for (size_t i = 0; i < 256; ++i)
-                new_state[i] = new_state[i] != state[(i * 7 + step * 13) % 256];
-
-            state = new_state;
-        }
-    }
-
-    for (int k = 0; k < 10; ++k) {
-        vector<bool> new_state(256);
-        for (size_t i = 0; i < 256; ++i) {
-            int left = state[(i + 255) % 256];
-            int center = state[i];
-            int right = state[(i + 1) % 256];
-            int pattern = (left << 2) | (center << 1) | right;
-            new_state[i] = ((rule >> pattern) & 1) ^ state[(i * 5 + k * 11) % 256];
+// Variantes reparties sur un pool de threads (file de taches : compteur atomique)
+template <class Registry>
+vector<TestResults> run_registry(const TestCorpus &tc, size_t num_tests, unsigned threads) {
+    vector<TestResults> results(Registry::size);
+    atomic<size_t> next{0};
+    mutex output;
+
+    auto worker = [&] {
+        for (;;) {
+            size_t index = next.fetch_add(1);
+            if (index >= Registry::size) break;
+            Registry::visit(index, [&](auto variant) {
+                using V = decltype(variant);
+                {
+                    lock_guard<mutex> guard(output);
+                    cout << "Testing " << V::name() << "..." << endl;
+                }
+                results[index] = test_hash_quality<V>(tc, num_tests);
+                lock_guard<mutex> guard(output);
+                cout << " " << V::name() << " completed" << endl;
+            });
         }
-        state = new_state;
-    }
-
-    stringstream hash_ss;
-    hash_ss << hex << setfill('0');
-    for (size_t i = 0; i < 256; i += 8) {
-        uint8_t byte = 0;
-        for (size_t j = 0; j < 8; ++j)
-            byte = (byte << 1) | state[i + j];
-        hash_ss << setw(2) << (int)byte;
-    }
-
-    return hash_ss.str();
-}
-
-string ac_hash_original_30(const string& input) {
-    return ac_hash_original(input, 30, 10);
-}
-
-string ac_hash_original_90(const string& input) {
-    return ac_hash_original(input, 90, 10);
-}
-
-string ac_hash_original_110(const string& input) {
-    return ac_hash_original(input, 110, 10);
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < min<size_t>(threads, Registry::size); t++) pool.emplace_back(worker);
+    worker();
+    for (thread &th : pool) th.join();
+
+    Registry::for_each([&](auto variant, size_t index) {
+        results[index].execution_time_ms = time_hash_function<decltype(variant)>(tc);
+    });
+    return results;
 }
 
-int main() {
-    const size_t NUM_TESTS = 1000;
+// Usage : Exercice10 [threads]
+int main(int argc, char **argv) {
+    const size_t NUM_TESTS = 1000;          // empreintes chronometrees
+    const size_t QUALITY_SAMPLES = 4096;    // au plus, par test de qualite
+    unsigned threads = (argc > 1) ? static_cast<unsigned>(stoul(argv[1])) : thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
     
     cout << "==============================================" << endl;
     cout << "COMPREHENSIVE HASH FUNCTION ANALYSIS" << endl;
     cout << "==============================================" << endl;
-    cout << "Number of tests per function: " << NUM_TESTS << endl << endl;
+    cout << "Number of tests per function: up to " << QUALITY_SAMPLES << " (sequential, stops at +/- "
+         << comparison_config().tolerance << "% at 99%)" << endl;
+    cout << "Corpus: " << corpus_kind_name(corpus_kind_from_env()) << ", seed " << corpus_seed_from_env()
+         << ", threads: " << threads << endl << endl;
     
-    vector<pair<string, function<string(const string&)>>> hash_functions = {
-        {"Original Rule 30", ac_hash_original_30},
-        {"Original Rule 90", ac_hash_original_90},
-        {"Original Rule 110", ac_hash_original_110},
-        {"AC-Hash+ Rule 30", ac_hash_30},
-        {"AC-Hash+ Rule 90", ac_hash_90},
-        {"AC-Hash+ Rule 110", ac_hash_110}
-    };
-    
-    vector<TestResults> all_results;
-    
-    // Exécution des tests
-    for (const auto& hash_func : hash_functions) {
-        all_results.push_back(test_hash_function(hash_func.first, hash_func.second, NUM_TESTS));
-    }
+    // Exécution des tests (variantes en parallele, corpus commun)
+    auto start = steady_clock::now();
+    TestCorpus corpus = make_test_corpus(QUALITY_SAMPLES, NUM_TESTS);
+    vector<TestResults> all_results = run_registry<ComparedVariants>(corpus, QUALITY_SAMPLES, threads);
+    double total_ms = duration<double, milli>(steady_clock::now() - start).count();
     
     // Affichage des résultats sous forme de tableau
     cout << "\n" << string(120, '=') << endl;
@@ -394,46 +246,53 @@ int main() {
     cout << left << setw(25) << "Hash Function" 
          << setw(15) << "Avalanche (%)" 
          << setw(15) << "Distribution (%)" 
-         << setw(15) << "Time (ms)" 
+         << setw(15) << "Time (ms)*" 
          << setw(30) << "Sample Hash" 
          << setw(15) << "Quality Score" << endl;
     cout << string(120, '-') << endl;
     
     cout << fixed << setprecision(2);
     
-    for (size_t i = 0; i < hash_functions.size(); ++i) {
-        double avalanche_dev = abs(50.0 - all_results[i].avalanche_effect);
-        double dist_dev = abs(50.0 - all_results[i].bit_distribution);
-        double quality_score = 100.0 - (avalanche_dev * 10 + dist_dev * 5 + all_results[i].execution_time_ms / 10);
-        
-        cout << left << setw(25) << hash_functions[i].first
+    for (size_t i = 0; i < all_results.size(); ++i) {
+        cout << left << setw(25) << all_results[i].name
              << setw(15) << all_results[i].avalanche_effect
              << setw(15) << all_results[i].bit_distribution
              << setw(15) << all_results[i].execution_time_ms
              << setw(30) << all_results[i].test_hash
-             << setw(15) << quality_score << endl;
+             << quality_score(all_results[i]) << " +/- " << quality_margin(all_results[i]) << endl;
+    }
+    
+    // Intervalles de confiance (echantillonnage sequentiel)
+    cout << string(120, '-') << endl;
+    cout << "* " << NUM_TESTS << " hashes, batch kernel (64 messages) when the variant has one. Total: "
+         << total_ms << " ms" << endl;
+    cout << "Confidence intervals (99%):" << endl;
+    for (size_t i = 0; i < all_results.size(); ++i) {
+        cout << "  " << left << setw(23) << all_results[i].name
+             << "avalanche " << all_results[i].avalanche_interval
+             << " | distribution " << all_results[i].distribution_interval << endl;
     }
     
     // Recommandation
     cout << string(120, '=') << endl;
     cout << "RECOMMENDATION:" << endl;
     
-    double best_score = 0;
-    string best_function;
-    
-    for (size_t i = 0; i < hash_functions.size(); ++i) {
-        double avalanche_dev = abs(50.0 - all_results[i].avalanche_effect);
-        double dist_dev = abs(50.0 - all_results[i].bit_distribution);
-        double quality_score = 100.0 - (avalanche_dev * 10 + dist_dev * 5 + all_results[i].execution_time_ms / 10);
-        
-        if (quality_score > best_score) {
-            best_score = quality_score;
-            best_function = hash_functions[i].first;
-        }
+    // Vainqueur seulement si son intervalle de score ne recoupe aucun autre
+    vector<double> scores, margins;
+    for (const TestResults &r : all_results) {
+        scores.push_back(quality_score(r));
+        margins.push_back(quality_margin(r));
+    }
+    vector<size_t> tied;
+    int best = best_separated(scores, margins, tied);
+    if (best >= 0) {
+        cout << "Best performing function: " << all_results[best].name << " " << endl;
+        cout << "Quality Score: " << scores[best] << " +/- " << margins[best] << "/100" << endl;
+    } else {
+        cout << "No significant winner: overlapping score intervals (99%) for" << endl;
+        for (size_t i : tied)
+            cout << "  " << left << setw(23) << all_results[i].name << scores[i] << " +/- " << margins[i] << endl;
     }
-    
-    cout << "Best performing function: " << best_function << " " << endl;
-    cout << "Quality Score: " << best_score << "/100" << endl;
     
     // Détails des améliorations
     cout << "\nIMPROVEMENTS IN AC-Hash+:" << endl;
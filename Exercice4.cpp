@@ -1,4 +1,4 @@
-#include "sha256.cpp"
+#include "achash.h"
 #include <iostream>
 #include <sstream>
 #include <ctime>
@@ -10,6 +10,11 @@
 #include <cstdlib>
 #include <bitset>
 #include <functional>
+#include "hash_config.h"
+#include "metrics.h"
+#include "logger.h"
+#include "trace.h"
+#include "perf_counters.h"
 
 using namespace std;
 using namespace std::chrono;
@@ -19,99 +24,16 @@ enum HashMode { SHA256_MODE, AC_HASH_MODE };
 HashMode currentHashMode = SHA256_MODE;
 uint32_t ac_hash_rule = 110;
 size_t ac_hash_steps = 3;
+bool ac_hash_plus_variant = false;   // ac_hash_plus (fichier de configuration autotune)
 
 // ==================== FONCTIONS DE HACHAGE ====================
 
-string sha256(const string &str);
-
-/**
- * Implémentation AC_HASH avec automate cellulaire
- */
-string ac_hash(const string& input, uint32_t rule, size_t steps) {
-    // 1. Conversion du texte en bits
-    vector<bool> input_bits;
-    for (char c : input) {
-        bitset<8> char_bits(c);
-        for (int i = 7; i >= 0; --i)
-            input_bits.push_back(char_bits[i]);
-    }
-
-    // 2. Padding façon SHA
-    size_t original_size = input_bits.size();
-    input_bits.push_back(1); // bit de fin
-    while ((input_bits.size() + 64) % 256 != 0)
-        input_bits.push_back(0);
-    
-    bitset<64> size_bits(original_size);
-    for (int i = 63; i >= 0; --i)
-        input_bits.push_back(size_bits[i]);
-
-    // 3. Initialisation de l'état
-    vector<bool> state(256, false);
-
-    // 4. Absorption des blocs
-    for (size_t block = 0; block < input_bits.size(); block += 256) {
-        // XOR bloc dans état
-        for (size_t i = 0; i < 256 && (block + i) < input_bits.size(); ++i)
-            state[i] = state[i] != input_bits[block + i];
-
-        // Application dynamique de l'automate
-        for (size_t step = 0; step < steps; ++step) {
-            vector<bool> new_state(256, false);
-
-            // Règle dynamique (change à chaque étape)
-            uint32_t dynamic_rule = (rule + step * 37 + block) % 256;
-            vector<bool> rule_bits(8);
-            for (int i = 0; i < 8; ++i)
-                rule_bits[7 - i] = (dynamic_rule >> i) & 1;
-
-            for (size_t i = 0; i < 256; ++i) {
-                int left = (i == 0) ? state[255] : state[i - 1];
-                int center = state[i];
-                int right = (i == 255) ? state[0] : state[i + 1];
-                int pattern = (left << 2) | (center << 1) | right;
-                new_state[i] = rule_bits[7 - pattern];
-            }
-
-            // Mélange additionnel
-            for (size_t i = 0; i < 256; ++i)
-                new_state[i] = new_state[i] != state[(i * 7 + step * 13) % 256];
-
-            state = new_state;
-        }
-    }
-
-    // 5. Finalisation (10 étapes supplémentaires)
-    for (int k = 0; k < 10; ++k) {
-        vector<bool> new_state(256);
-        for (size_t i = 0; i < 256; ++i) {
-            int left = state[(i + 255) % 256];
-            int center = state[i];
-            int right = state[(i + 1) % 256];
-            int pattern = (left << 2) | (center << 1) | right;
-            new_state[i] = ((rule >> pattern) & 1) ^ state[(i * 5 + k * 11) % 256];
-        }
-        state = new_state;
-    }
-
-    // 6. Conversion du résultat en hex
-    stringstream hash_ss;
-    hash_ss << hex << setfill('0');
-    for (size_t i = 0; i < 256; i += 8) {
-        uint8_t byte = 0;
-        for (size_t j = 0; j < 8; ++j)
-            byte = (byte << 1) | state[i + j];
-        hash_ss << setw(2) << (int)byte;
-    }
-
-    return hash_ss.str();
-}
-
 /**
  * Fonction de hachage principale qui sélectionne l'algorithme
  */
 string compute_hash(const string &str) {
     if (currentHashMode == AC_HASH_MODE) {
+        if (ac_hash_plus_variant) return ac_hash_plus(str, ac_hash_rule, ac_hash_steps);
         return ac_hash(str, ac_hash_rule, ac_hash_steps);
     } else {
         return sha256(str);
@@ -160,6 +82,9 @@ public:
     }
 
     void buildTree(const vector<Transaction> &transactions) {
+        METRIC_TIME(merkleTimer, METRIC_MERKLE_BUILD_TIME);
+        TRACE_SCOPE_ARG("buildTree", "transactions", transactions.size());
+        PERF_SCOPE(perf, "buildTree", 1);
         tree.clear();
         if (transactions.empty()) {
             tree.push_back({compute_hash("")});
@@ -170,11 +95,14 @@ public:
         for (const auto &tx : transactions)
             currentLevel.push_back(compute_hash(tx.toString()));
         tree.push_back(currentLevel);
+        size_t hashCount = currentLevel.size();
 
         while (currentLevel.size() > 1) {
             currentLevel = buildMerkleLevel(currentLevel);
             tree.push_back(currentLevel);
+            hashCount += currentLevel.size();
         }
+        perf.setOps(hashCount);
     }
 
     vector<string> buildMerkleLevel(const vector<string> &level) {
@@ -235,6 +163,7 @@ public:
     }
 
     void mineBlock(int difficulty) {
+        TRACE_SCOPE_ARG("mineBlock", "block", id);
         cout << "  Mining Block " << id << " with difficulty " << difficulty << " using ";
         cout << (currentHashMode == AC_HASH_MODE ? "AC_HASH" : "SHA256") << "...\n";
         
@@ -244,6 +173,7 @@ public:
         int iterations = 0;
         const int MAX_ITERATIONS = 50000;
         
+        PERF_SCOPE(perf, "mineBlock", 1);
         hash = calculateHash();
         
         bool hash_found = false;
@@ -252,8 +182,8 @@ public:
             if (hash.substr(0, difficulty) == target) {
                 hash_found = true;
             } else if (iterations >= MAX_ITERATIONS) {
-                cout << "     Maximum iterations reached (" << MAX_ITERATIONS << ")\n";
-                cout << "     Accepting current hash for demonstration: " << hash.substr(0, 64) << "\n";
+                LOG_INFO("     Maximum iterations reached ({})", MAX_ITERATIONS);
+                LOG_INFO("     Accepting current hash for demonstration: {}", hash.substr(0, 64));
                 hash_found = true;
             } else {
                 nonce++;
@@ -263,13 +193,18 @@ public:
                 if (iterations % 2000 == 0) {
                     auto current_time = high_resolution_clock::now();
                     auto elapsed = duration_cast<seconds>(current_time - start).count();
-                    cout << "    " << iterations << " iterations... " << elapsed << "s elapsed... Current hash: " << hash.substr(0, 16) << "...\n";
+                    LOG_INFO("    {} iterations... {}s elapsed... Current hash: {}...", iterations, elapsed, hash.substr(0, 16));
                 }
             }
         }
+        log_flush();
         
+        perf.setOps(iterations + 1);
         auto end = high_resolution_clock::now();
         auto duration = duration_cast<milliseconds>(end - start);
+        METRIC_ADD(METRIC_MINING_ATTEMPTS, iterations + 1);
+        METRIC_ADD(METRIC_BLOCKS_MINED, 1);
+        METRIC_RECORD(METRIC_MINING_TIME, duration_cast<nanoseconds>(end - start).count());
         
         if (hash.substr(0, difficulty) == target) {
             cout << "  Block mined successfully! Nonce: " << nonce << " | Hash: " << hash.substr(0, 64) << "\n";
@@ -281,11 +216,13 @@ public:
     }
 
     void validateBlock(const string &validateur) {
+        TRACE_SCOPE_ARG("validateBlock", "block", id);
         auto start = high_resolution_clock::now();
         validator = validateur;
         hash = calculateHash();
         auto end = high_resolution_clock::now();
         auto duration = duration_cast<microseconds>(end - start);
+        METRIC_RECORD(METRIC_BLOCK_VALIDATION_TIME, duration_cast<nanoseconds>(end - start).count());
         cout << "  Block " << id << " validated by: " << validator << " (Time: " << duration.count() << " us)\n\n";
     }
 
@@ -298,7 +235,8 @@ public:
         cout << "  Transactions: " << transactions.size() << " | Nonce: " << nonce << "\n";
         cout << "  Hash Mode: " << (currentHashMode == AC_HASH_MODE ? "AC_HASH" : "SHA256") << "\n";
         if (currentHashMode == AC_HASH_MODE) {
-            cout << "  AC_HASH Rule: " << ac_hash_rule << " | Steps: " << ac_hash_steps << "\n";
+            cout << "  AC_HASH Rule: " << ac_hash_rule << " | Steps: " << ac_hash_steps
+                 << (ac_hash_plus_variant ? " | AC-Hash+" : "") << "\n";
         }
         if (!validator.empty()) cout << "  Validator: " << validator << "\n";
         cout << "  Reward: " << blockReward << " tokens\n";
@@ -351,6 +289,7 @@ public:
     }
 
     void addBlockPoW(vector<Transaction> transactions, double reward = 10.0) {
+        TRACE_SCOPE_ARG("addBlockPoW", "block", chain.size());
         Block newBlock(chain.size(), chain.back().hash, transactions, reward);
         newBlock.mineBlock(difficulty);
         chain.push_back(newBlock);
@@ -358,20 +297,25 @@ public:
     }
 
     void addBlockPoS(vector<Transaction> transactions, double reward = 10.0) {
+        TRACE_SCOPE_ARG("addBlockPoS", "block", chain.size());
         if (stakes.empty() || totalStake == 0) {
             cerr << " No validators available for PoS!\n";
             return;
         }
         
-        double random = (double)rand() / RAND_MAX * totalStake;
-        double cumulative = 0;
         string selectedValidator;
-        
-        for (const auto &pair : stakes) {
-            cumulative += pair.second;
-            if (random <= cumulative) {
-                selectedValidator = pair.first;
-                break;
+        {
+            METRIC_TIME(selectionTimer, METRIC_POS_SELECTION_TIME);
+            TRACE_SCOPE("posSelection");
+            double random = (double)rand() / RAND_MAX * totalStake;
+            double cumulative = 0;
+            
+            for (const auto &pair : stakes) {
+                cumulative += pair.second;
+                if (random <= cumulative) {
+                    selectedValidator = pair.first;
+                    break;
+                }
             }
         }
         
@@ -386,6 +330,7 @@ public:
     }
 
     bool isChainValid() const {
+        TRACE_SCOPE_ARG("isChainValid", "blocks", chain.size());
         cout << "\nValidating " << chainName << "...\n";
         bool isValid = true;
         
@@ -470,6 +415,24 @@ public:
 
 // ==================== FONCTIONS UTILITAIRES ====================
 
+/**
+ * Applique la configuration ecrite par autotune (variante, regle, etapes)
+ */
+bool applyTunedHashConfig() {
+    HashConfig cfg;
+    if (!load_hash_config(cfg)) {
+        cout << "Fichier " << hash_config_path() << " absent ou invalide (lancer ./build/autotune)\n";
+        return false;
+    }
+    currentHashMode = AC_HASH_MODE;
+    ac_hash_plus_variant = cfg.plus;
+    ac_hash_rule = cfg.rule;
+    ac_hash_steps = cfg.steps;
+    cout << "Mode AC_HASH configure depuis " << hash_config_path() << " ("
+         << (cfg.plus ? "AC-Hash+, " : "") << "Regle: " << ac_hash_rule << ", Etapes: " << ac_hash_steps << ")\n";
+    return true;
+}
+
 /**
  * Fonction utilitaire pour dessiner des barres de progression
  */
@@ -487,6 +450,7 @@ string drawBar(double value, double maxVal, int length = 20) {
  * Fonction pour tester les performances entre ac_hash et SHA256
  */
 void testPerformance() {
+    TRACE_SCOPE("testPerformance");
     cout << "\n\n=== TEST DE PERFORMANCE AC_HASH vs SHA256 ===\n";
     cout << "============================================\n";
     
@@ -494,6 +458,13 @@ void testPerformance() {
     HashMode originalMode = currentHashMode;
     uint32_t originalRule = ac_hash_rule;
     size_t originalSteps = ac_hash_steps;
+    bool originalPlus = ac_hash_plus_variant;
+    
+    // Parametres AC_HASH : ceux d'autotune s'ils existent, sinon regle 110 / 3 etapes
+    HashConfig tuned;
+    bool hasTuned = load_hash_config(tuned);
+    cout << "AC_HASH: " << (tuned.plus ? "AC-Hash+, " : "") << "Regle " << tuned.rule << ", Etapes " << tuned.steps
+         << (hasTuned ? " (" + hash_config_path() + ")" : " (defaut)") << "\n";
     
     // Données de test pour le minage
     vector<Transaction> testTransactions = {
@@ -525,8 +496,9 @@ void testPerformance() {
             currentHashMode = SHA256_MODE;
         } else {
             currentHashMode = AC_HASH_MODE;
-            ac_hash_rule = 110;
-            ac_hash_steps = 3;
+            ac_hash_plus_variant = tuned.plus;
+            ac_hash_rule = tuned.rule;
+            ac_hash_steps = tuned.steps;
         }
         
         double totalTime = 0;
@@ -545,6 +517,7 @@ void testPerformance() {
             string hash;
             int nonce = 0;
             
+            PERF_SCOPE(perf, method == "SHA256" ? "sha256" : "ac_hash", 1);
             auto start = high_resolution_clock::now();
             
             do {
@@ -561,6 +534,7 @@ void testPerformance() {
                 
             } while (hash.substr(0, DIFFICULTY) != target);
             
+            perf.setOps(iteration_count);
             auto end = high_resolution_clock::now();
             auto duration = duration_cast<microseconds>(end - start); // Changé en microseconds pour plus de précision
             
@@ -589,6 +563,7 @@ void testPerformance() {
     currentHashMode = originalMode;
     ac_hash_rule = originalRule;
     ac_hash_steps = originalSteps;
+    ac_hash_plus_variant = originalPlus;
     
     // Affichage des résultats dans un tableau
     cout << "\n\n=== RAPPORT DE COMPARAISON ===\n";
@@ -614,6 +589,9 @@ void testPerformance() {
     }
     cout << "+----------+------------------+------------------+------------------+------------------+\n";
     
+    // Compteurs matériels (si compilé avec -DAC_PERF_COUNTERS)
+    PERF_REPORT();
+    
     // Analyse comparative détaillée - TOUJOURS AFFICHER MÊME SI TEMPS = 0
     cout << "\n=== ANALYSE COMPARATIVE DETAILLEE ===\n";
     double sha256Time = results["SHA256"].avgTime;
@@ -808,6 +786,8 @@ void runNormalDemo() {
     cout << "\n\n=== AFFICHAGE DETAILLE DES CHAINES ===\n";
     cout << "=================================\n";
 
+    PERF_REPORT();
+
     cout << "\nAppuyez sur Entree pour voir les details de la chaine PoW...";
     cin.ignore();
     cin.get();
@@ -833,6 +813,7 @@ int main() {
         cout << "1. SHA256 (Standard)\n";
         cout << "2. AC_HASH (Automate Cellulaire)\n"; 
         cout << "3. Test Performance (AC_HASH vs SHA256)\n";
+        cout << "4. AC_HASH (configuration autotune: " << hash_config_path() << ")\n";
         cout << "0. Quitter\n";
         cout << "Choix: ";
         cin >> mainChoice;
@@ -855,6 +836,9 @@ int main() {
             case 3:
                 testPerformance();
                 break;
+            case 4:
+                if (applyTunedHashConfig()) runNormalDemo();
+                break;
             case 0:
                 cout << "Au revoir!\n";
                 break;
@@ -8,92 +8,16 @@
 #include <random>
 #include <algorithm>
 #include <cmath>
+#include "achash.h"
+#include "logger.h"
+#include "trace.h"
+#include "avalanche.h"
+#include "sequential.h"
 using namespace std;
 
-// Version COMPLÈTEMENT REVISÉE de AC_HASH
-string ac_hash(const string& input, uint32_t rule, size_t steps) {
-    // 1. Conversion du texte en bits
-    vector<bool> input_bits;
-    for (char c : input) {
-        bitset<8> char_bits(c);
-        for (int i = 7; i >= 0; --i)
-            input_bits.push_back(char_bits[i]);
-    }
-
-    // 2. Padding façon SHA
-    size_t original_size = input_bits.size();
-    input_bits.push_back(1); // bit de fin
-    while ((input_bits.size() + 64) % 256 != 0)
-        input_bits.push_back(0);
-    
-    bitset<64> size_bits(original_size);
-    for (int i = 63; i >= 0; --i)
-        input_bits.push_back(size_bits[i]);
-
-    // 3. Initialisation de l'état
-    vector<bool> state(256, false);
-
-    // 4. Absorption des blocs
-    for (size_t block = 0; block < input_bits.size(); block += 256) {
-        // XOR bloc dans état
-        for (size_t i = 0; i < 256 && (block + i) < input_bits.size(); ++i)
-            state[i] = state[i] != input_bits[block + i];
-
-        // Application dynamique de l'automate
-        for (size_t step = 0; step < steps; ++step) {
-            vector<bool> new_state(256, false);
-
-            // Règle dynamique (change à chaque étape)
-            uint32_t dynamic_rule = (rule + step * 37 + block) % 256;
-            vector<bool> rule_bits(8);
-            for (int i = 0; i < 8; ++i)
-                rule_bits[7 - i] = (dynamic_rule >> i) & 1;
-
-            for (size_t i = 0; i < 256; ++i) {
-                int left = (i == 0) ? state[255] : state[i - 1];
-                int center = state[i];
-                int right = (i == 255) ? state[0] : state[i + 1];
-                int pattern = (left << 2) | (center << 1) | right;
-                new_state[i] = rule_bits[7 - pattern];
-            }
-
-            // Mélange additionnel
-            for (size_t i = 0; i < 256; ++i)
-                new_state[i] = new_state[i] != state[(i * 7 + step * 13) % 256];
-
-            state = new_state;
-        }
-    }
-
-    // 5. Finalisation (10 étapes supplémentaires)
-    for (int k = 0; k < 10; ++k) {
-        vector<bool> new_state(256);
-        for (size_t i = 0; i < 256; ++i) {
-            int left = state[(i + 255) % 256];
-            int center = state[i];
-            int right = state[(i + 1) % 256];
-            int pattern = (left << 2) | (center << 1) | right;
-            new_state[i] = ((rule >> pattern) & 1) ^ state[(i * 5 + k * 11) % 256];
-        }
-        state = new_state;
-    }
-
-    // 6. Conversion du résultat en hex
-    stringstream hash_ss;
-    hash_ss << hex << setfill('0');
-    for (size_t i = 0; i < 256; i += 8) {
-        uint8_t byte = 0;
-        for (size_t j = 0; j < 8; ++j)
-            byte = (byte << 1) | state[i + j];
-        hash_ss << setw(2) << (int)byte;
-    }
-
-    return hash_ss.str();
-}
-
-
 // Test d'effet avalanche COMPLET
-void comprehensive_avalanche_test() {
+void comprehensive_avalanche_test(const AvalancheConfig &cfg) {
+    TRACE_SCOPE("comprehensive_avalanche_test");
     cout << "=== TEST EFFET AVALANCHE COMPLET ===" << endl;
     cout << "Comparaison entre l'ancienne et nouvelle version AC_HASH" << endl;
     
@@ -111,83 +35,62 @@ void comprehensive_avalanche_test() {
         string hash1 = ac_hash(msg1, 30, 100);  // Using rule 30 and 100 steps
         string hash2 = ac_hash(msg2, 30, 100);  // Using rule 30 and 100 steps
         
-        cout << "Message 1: \"" << msg1 << "\" -> " << hash1.substr(0, 16) << "..." << endl;
-        cout << "Message 2: \"" << msg2 << "\" -> " << hash2.substr(0, 16) << "..." << endl;
-        cout << "Similarite: " << (hash1 == hash2 ? "COLLISION!" : "OK") << endl << endl;
+        LOG_INFO("Message 1: \"{}\" -> {}...", msg1, hash1.substr(0, 16));
+        LOG_INFO("Message 2: \"{}\" -> {}...", msg2, hash2.substr(0, 16));
+        LOG_INFO("Similarite: {}\n", hash1 == hash2 ? "COLLISION!" : "OK");
     }
+    log_flush();
     
-    // Test d'effet avalanche détaillé
+    // Test d'effet avalanche détaillé : chaque bit de chaque message est inverse
     cout << "\n2. TEST EFFET AVALANCHE DETAILLE:" << endl;
-    int num_tests = 50;
-    int collisions = 0;
-    vector<double> percentages;
-    
-    for (int i = 0; i < num_tests; i++) {
-        string original = "TestMessage" + to_string(i);
-        
-        // Modifier un bit à différentes positions
-        for (int bit_pos = 0; bit_pos < 8; bit_pos++) {
-            string modified = original;
-            if (!modified.empty()) {
-                char& c = modified[modified.length() / 2];
-                c ^= (1 << bit_pos);
-                
-                string hash1 = ac_hash(original, 30, 100);  // Using rule 30 and 100 steps
-                string hash2 = ac_hash(modified, 30, 100);  // Using rule 30 and 100 steps
-                
-                if (hash1 == hash2) {
-                    collisions++;
-                    cout << "COLLISION: \"" << original << "\" vs \"" << modified << "\"" << endl;
-                }
-                
-                // Calculer le pourcentage de bits différents
-                int diff_bits = 0;
-                for (size_t j = 0; j < hash1.length() && j < hash2.length(); j++) {
-                    bitset<8> bits1(hash1[j]);
-                    bitset<8> bits2(hash2[j]);
-                    diff_bits += (bits1 ^ bits2).count();
-                }
-                double percentage = (diff_bits * 100.0) / (hash1.length() * 8);
-                percentages.push_back(percentage);
-            }
-        }
-        
-        if ((i + 1) % 10 == 0) {
-            cout << "Progression: " << (i + 1) << "/" << num_tests << endl;
-        }
-    }
-    
+    AvalancheResult result = run_avalanche(cfg, [](const string &m) {
+        return ac_hash_digest(m, 30, 100);  // Using rule 30 and 100 steps
+    });
+    cout << "Messages: " << cfg.messages << " x " << cfg.messageLength << " octets, "
+         << "graine " << cfg.seed << ", " << result.threads << " thread(s)" << endl;
+    cout << "Paires (original, 1 bit inverse): " << result.pairs
+         << ", hashs calcules: " << result.hashes << endl;
+
     // Analyse statistique
-    if (!percentages.empty()) {
-        double total = 0;
-        double min_pct = 100, max_pct = 0;
-        for (double p : percentages) {
-            total += p;
-            if (p < min_pct) min_pct = p;
-            if (p > max_pct) max_pct = p;
-        }
-        double average = total / percentages.size();
-        
+    if (result.pairs > 0) {
+        uint64_t collisions = result.histogram[0];
+        double average = result.mean() * 100.0 / 256;
+        double min_pct = result.minDistance() * 100.0 / 256;
+        double max_pct = result.maxDistance() * 100.0 / 256;
+
         cout << "\n3. RESULTATS STATISTIQUES:" << endl;
-        cout << "Tests effectues: " << percentages.size() << endl;
+        cout << "Tests effectues: " << result.pairs << endl;
         cout << "Collisions detectees: " << collisions << endl;
         cout << "Pourcentage moyen de bits differents: " << fixed << setprecision(2) << average << "%" << endl;
+        cout << "Ecart-type: " << fixed << setprecision(2) << result.stddev() << " bits (attendu: 8.00)" << endl;
         cout << "Minimum: " << fixed << setprecision(2) << min_pct << "%" << endl;
         cout << "Maximum: " << fixed << setprecision(2) << max_pct << "%" << endl;
         
         // Distribution
-        vector<int> distribution(10, 0);
-        for (double p : percentages) {
-            int bucket = min(static_cast<int>(p / 10), 9);
-            distribution[bucket]++;
+        vector<uint64_t> distribution(10, 0);
+        for (int d = 0; d < AVALANCHE_BINS; d++) {
+            int bucket = min(static_cast<int>(d * 100.0 / 256 / 10), 9);
+            distribution[bucket] += result.histogram[d];
         }
         
         cout << "\nDistribution:" << endl;
         for (int i = 0; i < 10; i++) {
-            double pct = (distribution[i] * 100.0) / percentages.size();
+            double pct = (distribution[i] * 100.0) / result.pairs;
             cout << setw(2) << (i * 10) << "-" << setw(2) << ((i + 1) * 10) << "%: " 
                  << distribution[i] << " tests (" << fixed << setprecision(1) << pct << "%)" << endl;
         }
+
+        // Histogramme complet des distances de Hamming
+        cout << "\nHistogramme des distances de Hamming (observe / attendu Binomial(256, 0.5)):" << endl;
+        for (int d = result.minDistance(); d <= result.maxDistance(); d++) {
+            double expected = result.pairs * binomial_half_pmf(256, d);
+            cout << setw(4) << d << ": " << setw(10) << result.histogram[d]
+                 << setw(14) << fixed << setprecision(1) << expected << endl;
+        }
+
+        GoodnessOfFit fit = avalanche_goodness_of_fit(result);
+        cout << "\nAjustement a Binomial(256, 0.5): chi2 = " << fixed << setprecision(2) << fit.chiSquared
+             << ", ddl = " << fit.degreesOfFreedom << ", p-value = " << setprecision(4) << fit.pValue << endl;
         
         // Évaluation
         cout << "\n4. EVALUATION FINALE:" << endl;
@@ -202,11 +105,42 @@ void comprehensive_avalanche_test() {
         } else {
             cout << " INSUFFISANT: Effet avalanche trop faible" << endl;
         }
+        if (fit.degreesOfFreedom > 0) {
+            cout << (fit.pValue >= 0.01 ? " Distribution compatible avec Binomial(256, 0.5)"
+                                        : " Distribution NON compatible avec Binomial(256, 0.5) (p < 0.01)") << endl;
+        }
     }
 }
 
+// Estimation sequentielle : paires (message i, un bit inverse) tirees jusqu'a decision
+void sequential_avalanche_test(const AvalancheConfig &cfg) {
+    TRACE_SCOPE("sequential_avalanche_test");
+    cout << "\n5. ESTIMATION SEQUENTIELLE (intervalle a 99%, SPRT +/- 2%):" << endl;
+
+    SequentialConfig sequential;
+    sequential.maxSamples = cfg.messages * 8 * cfg.messageLength;  // budget du test complet
+    SequentialEstimator estimator(sequential);
+
+    string original;
+    for (uint64_t i = 0; !estimator.done(); i++) {
+        avalanche_message(cfg, i, original);
+        Digest256 h0 = ac_hash_digest(original, 30, 100);
+        uint64_t bit = CounterRng(cfg.seed, i).at(cfg.messageLength) % (8 * cfg.messageLength);
+        original[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+        estimator.add(digest_hamming(h0, ac_hash_digest(original, 30, 100)) * 100.0 / 256);
+    }
+
+    cout << "Bits differents: " << estimator.summary() << endl;
+    cout << "Paires utilisees: " << estimator.count() << " sur " << sequential.maxSamples
+         << " (" << fixed << setprecision(1) << estimator.count() * 100.0 / sequential.maxSamples
+         << "% du test complet)" << endl;
+    cout << (estimator.acceptable() ? " Effet avalanche conforme (50% +/- 2%)"
+                                    : " Effet avalanche NON conforme (hors 50% +/- 2%)") << endl;
+}
+
 // Test de performance basique
 void basic_hash_tests() {
+    TRACE_SCOPE("basic_hash_tests");
     cout << "=== TESTS DE BASE ===" << endl;
     
     vector<pair<string, string>> test_cases = {
@@ -223,12 +157,20 @@ void basic_hash_tests() {
     }
 }
 
-int main() {
+// Usage : Exercice5 [messages] [longueur] [threads] [graine]
+int main(int argc, char **argv) {
+    AvalancheConfig cfg;
+    if (argc > 1) cfg.messages = stoul(argv[1]);
+    if (argc > 2) cfg.messageLength = stoul(argv[2]);
+    if (argc > 3) cfg.threads = static_cast<unsigned>(stoul(argv[3]));
+    if (argc > 4) cfg.seed = stoull(argv[4]);
+
     cout << "ANALYSE AC_HASH - EFFET AVALANCHE" << endl;
     cout << "==================================" << endl;
     
     basic_hash_tests();
-    comprehensive_avalanche_test();
+    comprehensive_avalanche_test(cfg);
+    sequential_avalanche_test(cfg);
     
     return 0;
 }
\ No newline at end of file
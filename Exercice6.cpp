@@ -4,109 +4,16 @@
 #include <sstream>
 #include <iomanip>
 #include <string>
-#include <random>
 #include <cmath>
+#include "achash.h"
+#include "corpus.h"
+#include "digest_stats.h"
+#include "logger.h"
+#include "sequential.h"
+#include "trace.h"
 
 using namespace std;
 
-string ac_hash(const string& input, uint32_t rule, size_t steps) {
-    vector<bool> input_bits;
-    for (char c : input) {
-        bitset<8> char_bits(c);
-        for (int i = 7; i >= 0; --i)
-            input_bits.push_back(char_bits[i]);
-    }
-
-    size_t original_size = input_bits.size();
-    input_bits.push_back(1);
-    while ((input_bits.size() + 64) % 256 != 0)
-        input_bits.push_back(0);
-    
-    bitset<64> size_bits(original_size);
-    for (int i = 63; i >= 0; --i)
-        input_bits.push_back(size_bits[i]);
-
-    vector<bool> state(256, false);
-
-    for (size_t block = 0; block < input_bits.size(); block += 256) {
-        for (size_t i = 0; i < 256 && (block + i) < input_bits.size(); ++i)
-            state[i] = state[i] != input_bits[block + i];
-
-        for (size_t step = 0; step < steps; ++step) {
-            vector<bool> new_state(256, false);
-            uint32_t dynamic_rule = (rule + step * 37 + block) % 256;
-            vector<bool> rule_bits(8);
-            for (int i = 0; i < 8; ++i)
-                rule_bits[7 - i] = (dynamic_rule >> i) & 1;
-
-            for (size_t i = 0; i < 256; ++i) {
-                int left = (i == 0) ? state[255] : state[i - 1];
-                int center = state[i];
-                int right = (i == 255) ? state[0] : state[i + 1];
-                int pattern = (left << 2) | (center << 1) | right;
-                new_state[i] = rule_bits[7 - pattern];
-            }
-
-            for (size_t i = 0; i < 256; ++i)
-                new_state[i] = new_state[i] != state[(i * 7 + step * 13) % 256];
-
-            state = new_state;
-        }
-    }
-
-    for (int k = 0; k < 10; ++k) {
-        vector<bool> new_state(256);
-        for (size_t i = 0; i < 256; ++i) {
-            int left = state[(i + 255) % 256];
-            int center = state[i];
-            int right = state[(i + 1) % 256];
-            int pattern = (left << 2) | (center << 1) | right;
-            new_state[i] = ((rule >> pattern) & 1) ^ state[(i * 5 + k * 11) % 256];
-        }
-        state = new_state;
-    }
-
-    stringstream hash_ss;
-    hash_ss << hex << setfill('0');
-    for (size_t i = 0; i < 256; i += 8) {
-        uint8_t byte = 0;
-        for (size_t j = 0; j < 8; ++j)
-            byte = (byte << 1) | state[i + j];
-        hash_ss << setw(2) << (int)byte;
-    }
-
-    return hash_ss.str();
-}
-
-// Fonction pour extraire les bits d'un hash hexadécimal
-vector<bool> hash_to_bits(const string& hash) {
-    vector<bool> bits;
-    for (char c : hash) {
-        int value;
-        stringstream ss;
-        ss << hex << c;
-        ss >> value;
-        bitset<4> nibble(value);
-        for (int i = 3; i >= 0; --i) {
-            bits.push_back(nibble[i]);
-        }
-    }
-    return bits;
-}
-
-// Générer un message aléatoire
-string generate_random_message(size_t length) {
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> dis(32, 126);
-    
-    string message;
-    for (size_t i = 0; i < length; ++i) {
-        message += static_cast<char>(dis(gen));
-    }
-    return message;
-}
-
 // Test statistique du chi-carré pour l'équilibre des bits
 double chi_squared_test(int ones_count, int total_bits) {
     double expected = total_bits / 2.0;
@@ -115,8 +22,9 @@ double chi_squared_test(int ones_count, int total_bits) {
     return chi_squared;
 }
 
-int main() {
-    const size_t TARGET_BITS = 100000;  // Au moins 10⁵ bits
+// Usage : Exercice6 [tolerance en %] [bits max]
+int main(int argc, char **argv) {
+    const size_t TARGET_BITS = (argc > 2) ? stoul(argv[2]) : 100000;  // Au plus 10⁵ bits
     const size_t MESSAGE_LENGTH = 64;   // Longueur des messages en octets
     const uint32_t RULE = 110;
     const size_t STEPS = 10;
@@ -126,45 +34,59 @@ int main() {
     size_t hash_count = 0;
     
     cout << "Analyse de la distribution des bits de ac_hash..." << endl;
-    cout << "Objectif: au moins " << TARGET_BITS << " bits" << endl;
+    // Arret des que l'intervalle a 99% du pourcentage de 1 par hash est assez
+    // etroit (sans SPRT : les analyses par position ont besoin de l'echantillon)
+    SequentialConfig sequential;
+    sequential.tolerance = (argc > 1) ? stod(argv[1]) : 0.45;  // Atteignable en ~320 hashes (< 10⁵ bits)
+    sequential.sprt = false;
+    sequential.maxSamples = (TARGET_BITS + DIGEST_BITS - 1) / DIGEST_BITS;
+    SequentialEstimator estimator(sequential);
+    
+    cout << "Objectif: intervalle +/- " << sequential.tolerance << "% (99%), au plus "
+         << TARGET_BITS << " bits" << endl;
     cout << "Regle: " << RULE << ", Etapes: " << STEPS << endl << endl;
     
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<uint32_t> rule_dis(0, 255);
+    // Messages reproductibles (AC_CORPUS / AC_SEED)
+    MessageCorpus corpus(corpus_kind_from_env(), MESSAGE_LENGTH, corpus_seed_from_env());
+    string message;
+    cout << "Corpus: " << corpus_kind_name(corpus.corpusKind()) << ", graine " << corpus_seed_from_env() << endl << endl;
     
     // Utiliser différentes règles pour plus de variété
     vector<uint32_t> rules = {30, 45, 73, 89, 101, 110, 124, 135, 149, 150, 
                               153, 165, 182, 184, 188, 190, 193, 195, 210, 222};
     
-    while (total_bits < TARGET_BITS) {
+    // Une seule passe : ratio global, biais par position et octets
+    BitPositionCounter position_counter;
+    ByteHistogram byte_histogram;
+    
+    TraceScope distributionSpan("distribution");
+    while (!estimator.done()) {
         // Générer un message aléatoire
-        string message = generate_random_message(MESSAGE_LENGTH);
+        message.assign(corpus.next());
         
         // Choisir une règle aléatoire parmi la liste
         uint32_t current_rule = rules[hash_count % rules.size()];
         
-        // Calculer le hash
-        string hash = ac_hash(message, current_rule, STEPS);
+        // Calculer le hash (empreinte brute)
+        Digest256 hash = ac_hash_digest(message, current_rule, STEPS);
         
-        // Extraire les bits
-        vector<bool> bits = hash_to_bits(hash);
+        int ones = digest_ones(hash);
+        total_ones += ones;
+        estimator.add(ones * 100.0 / DIGEST_BITS);
+        position_counter.add(hash);
+        byte_histogram.add(hash);
         
-        // Compter les bits à 1
-        for (bool bit : bits) {
-            if (bit) total_ones++;
-        }
-        
-        total_bits += bits.size();
+        total_bits += DIGEST_BITS;
         hash_count++;
         
         if (hash_count % 100 == 0) {
             double percentage = (total_ones * 100.0) / total_bits;
-            cout << "Hashs calcules: " << hash_count 
-                 << ", Bits analyses: " << total_bits 
-                 << ", Pourcentage de 1: " << fixed << setprecision(4) << percentage << "%" << endl;
+            LOG_INFO("Hashs calcules: {}, Bits analyses: {}, Pourcentage de 1: {:.4f}%",
+                     hash_count, total_bits, percentage);
         }
     }
+    log_flush();
+    distributionSpan.stop();
     
     // Calcul des résultats finaux
     double percentage_ones = (total_ones * 100.0) / total_bits;
@@ -185,36 +107,21 @@ int main() {
     cout << "Valeur du test chi-carre: " << fixed << setprecision(4) << chi_squared << endl;
     cout << "Seuil chi-carre (95%): " << CHI_SQUARED_THRESHOLD << endl;
     cout << "Distribution equilibree: " << (is_balanced ? "OUI" : "NON") << endl;
+    cout << "Intervalle de confiance (99%): " << estimator.summary(4) << endl;
     
     // Analyse supplémentaire par octet
     cout << "\n=== ANALYSE PAR OCTET ===" << endl;
     cout << "Bits analyses par position de bit (0-255 dans le hash):" << endl;
     
-    // Réinitialiser pour analyser par position
-    total_bits = 0;
-    vector<size_t> position_ones(256, 0);
-    vector<size_t> position_count(256, 0);
-    
-    for (size_t i = 0; i < min(hash_count, static_cast<size_t>(1000)); ++i) {
-        string message = generate_random_message(MESSAGE_LENGTH);
-        uint32_t current_rule = rules[i % rules.size()];
-        string hash = ac_hash(message, current_rule, STEPS);
-        vector<bool> bits = hash_to_bits(hash);
-        
-        for (size_t j = 0; j < bits.size(); ++j) {
-            if (bits[j]) position_ones[j]++;
-            position_count[j]++;
-        }
-        total_bits += bits.size();
-    }
+    const uint64_t *position_ones = position_counter.ones();
     
     // Afficher les statistiques par position
     double max_deviation = 0;
     double min_percentage = 100, max_percentage = 0;
     
-    for (size_t i = 0; i < 256; ++i) {
-        if (position_count[i] > 0) {
-            double pos_percentage = (position_ones[i] * 100.0) / position_count[i];
+    for (size_t i = 0; i < DIGEST_BITS; ++i) {
+        if (position_counter.count() > 0) {
+            double pos_percentage = (position_ones[i] * 100.0) / position_counter.count();
             double deviation = abs(50.0 - pos_percentage);
             
             if (pos_percentage < min_percentage) min_percentage = pos_percentage;
@@ -227,5 +134,27 @@ int main() {
     cout << "Pourcentage max de 1 sur une position: " << fixed << setprecision(2) << max_percentage << "%" << endl;
     cout << "Deviation maximale: " << fixed << setprecision(2) << max_deviation << "%" << endl;
     
+    // Histogramme des valeurs d'octets (255 ddl par position, 255 ddl global)
+    double global_chi2 = byte_histogram.chiSquared();
+    double worst_chi2 = 0;
+    int worst_byte = 0;
+    for (int k = 0; k < DIGEST_BYTES; ++k) {
+        double chi2 = byte_histogram.chiSquared(k);
+        if (chi2 > worst_chi2) {
+            worst_chi2 = chi2;
+            worst_byte = k;
+        }
+    }
+    cout << "\n=== HISTOGRAMME DES OCTETS ===" << endl;
+    cout << "Chi-carre global des valeurs d'octets: " << fixed << setprecision(2) << global_chi2
+         << " (p-value: " << setprecision(4) << chi2_pvalue(global_chi2, 255) << ")" << endl;
+    // Maximum de DIGEST_BYTES tests : correction de Sidak sur la p-value brute
+    double worst_p = 1.0 - pow(1.0 - chi2_pvalue(worst_chi2, 255), DIGEST_BYTES);
+    cout << "Octet le moins uniforme: " << worst_byte << ", chi-carre: " << setprecision(2) << worst_chi2
+         << " (p-value corrigee sur " << DIGEST_BYTES << " octets: " << setprecision(4) << worst_p << ")" << endl;
+    if (hash_count < 5 * 256) {
+        cout << "(moins de 5 valeurs attendues par case : approximation du chi-carre par octet peu fiable)" << endl;
+    }
+    
     return 0;
 }
\ No newline at end of file
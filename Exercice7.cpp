@@ -4,189 +4,74 @@
 #include <sstream>
 #include <iomanip>
 #include <string>
-#include <random>
 #include <chrono>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include "achash.h"
+#include "avalanche.h"
+#include "corpus.h"
+#include "digest_stats.h"
+#include "sequential.h"
+#include "trace.h"
 
 using namespace std;
 using namespace std::chrono;
 
-string ac_hash(const string& input, uint32_t rule, size_t steps) {
-    vector<bool> input_bits;
-    for (char c : input) {
-        bitset<8> char_bits(c);
-        for (int i = 7; i >= 0; --i)
-            input_bits.push_back(char_bits[i]);
-    }
-
-    size_t original_size = input_bits.size();
-    input_bits.push_back(1);
-    while ((input_bits.size() + 64) % 256 != 0)
-        input_bits.push_back(0);
-    
-    bitset<64> size_bits(original_size);
-    for (int i = 63; i >= 0; --i)
-        input_bits.push_back(size_bits[i]);
-
-    vector<bool> state(256, false);
-
-    for (size_t block = 0; block < input_bits.size(); block += 256) {
-        for (size_t i = 0; i < 256 && (block + i) < input_bits.size(); ++i)
-            state[i] = state[i] != input_bits[block + i];
-
-        for (size_t step = 0; step < steps; ++step) {
-            vector<bool> new_state(256, false);
-            uint32_t dynamic_rule = (rule + step * 37 + block) % 256;
-            vector<bool> rule_bits(8);
-            for (int i = 0; i < 8; ++i)
-                rule_bits[7 - i] = (dynamic_rule >> i) & 1;
-
-            for (size_t i = 0; i < 256; ++i) {
-                int left = (i == 0) ? state[255] : state[i - 1];
-                int center = state[i];
-                int right = (i == 255) ? state[0] : state[i + 1];
-                int pattern = (left << 2) | (center << 1) | right;
-                new_state[i] = rule_bits[7 - pattern];
-            }
-
-            for (size_t i = 0; i < 256; ++i)
-                new_state[i] = new_state[i] != state[(i * 7 + step * 13) % 256];
-
-            state = new_state;
-        }
-    }
-
-    for (int k = 0; k < 10; ++k) {
-        vector<bool> new_state(256);
-        for (size_t i = 0; i < 256; ++i) {
-            int left = state[(i + 255) % 256];
-            int center = state[i];
-            int right = state[(i + 1) % 256];
-            int pattern = (left << 2) | (center << 1) | right;
-            new_state[i] = ((rule >> pattern) & 1) ^ state[(i * 5 + k * 11) % 256];
-        }
-        state = new_state;
-    }
-
-    stringstream hash_ss;
-    hash_ss << hex << setfill('0');
-    for (size_t i = 0; i < 256; i += 8) {
-        uint8_t byte = 0;
-        for (size_t j = 0; j < 8; ++j)
-            byte = (byte << 1) | state[i + j];
-        hash_ss << setw(2) << (int)byte;
-    }
-
-    return hash_ss.str();
-}
-
 // Fonctions utilitaires pour les tests
-double count_bit_difference(const string& hash1, const string& hash2) {
-    if (hash1.length() != hash2.length()) return -1;
-    
-    int total_bits = hash1.length() * 4;
-    int diff_count = 0;
-    
-    for (size_t i = 0; i < hash1.length(); ++i) {
-        int val1, val2;
-        stringstream ss1, ss2;
-        ss1 << hex << hash1[i];
-        ss2 << hex << hash2[i];
-        ss1 >> val1;
-        ss2 >> val2;
-        
-        bitset<4> bits1(val1);
-        bitset<4> bits2(val2);
-        bitset<4> diff = bits1 ^ bits2;
-        diff_count += diff.count();
-    }
-    
-    return (diff_count * 100.0) / total_bits;
+double count_bit_difference(const Digest256& hash1, const Digest256& hash2) {
+    return (digest_hamming(hash1, hash2) * 100.0) / DIGEST_BITS;
 }
 
-string generate_random_message(size_t length) {
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> dis(32, 126);
-    
-    string message;
-    for (size_t i = 0; i < length; ++i) {
-        message += static_cast<char>(dis(gen));
-    }
-    return message;
-}
-
-string flip_random_bit(const string& message) {
-    if (message.empty()) return message;
-    
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> byte_dis(0, message.length() - 1);
-    uniform_int_distribution<> bit_dis(0, 7);
-    
-    string modified = message;
-    size_t byte_pos = byte_dis(gen);
-    int bit_pos = bit_dis(gen);
-    
-    modified[byte_pos] ^= (1 << bit_pos);
-    return modified;
-}
-
-double test_avalanche_effect(uint32_t rule, size_t steps, size_t num_tests = 500) {
-    double total_diff = 0.0;
-    int valid_tests = 0;
-    
-    for (size_t i = 0; i < num_tests; ++i) {
-        string original = generate_random_message(64);
-        string modified = flip_random_bit(original);
+// Echantillonnage sequentiel : au plus cfg.maxSamples paires, arret selon cfg
+SequentialEstimator test_avalanche_effect(uint32_t rule, size_t steps, const SequentialConfig &cfg) {
+    TRACE_SCOPE_ARG("test_avalanche_effect", "rule", rule);
+    SequentialEstimator estimator(cfg);
+    MessageCorpus corpus(corpus_kind_from_env(), 64, corpus_seed_from_env(), 0);
+    string original, modified;
+    
+    while (!estimator.done()) {
+        original.assign(corpus.next());
+        modified = original;
+        flip_random_bit(modified, corpus.rng());
         
-        string hash_original = ac_hash(original, rule, steps);
-        string hash_modified = ac_hash(modified, rule, steps);
+        Digest256 hash_original = ac_hash_digest(original, rule, steps);
+        Digest256 hash_modified = ac_hash_digest(modified, rule, steps);
         
-        double diff_percentage = count_bit_difference(hash_original, hash_modified);
-        
-        if (diff_percentage >= 0) {
-            total_diff += diff_percentage;
-            valid_tests++;
-        }
+        estimator.add(count_bit_difference(hash_original, hash_modified));
     }
     
-    return total_diff / valid_tests;
+    return estimator;
 }
 
-double test_bit_distribution(uint32_t rule, size_t steps, size_t target_bits = 50000) {
-    size_t total_bits = 0;
-    size_t total_ones = 0;
+// Une observation = pourcentage de 1 d'une empreinte ; au plus cfg.maxSamples empreintes
+SequentialEstimator test_bit_distribution(uint32_t rule, size_t steps, const SequentialConfig &cfg) {
+    TRACE_SCOPE_ARG("test_bit_distribution", "rule", rule);
+    SequentialEstimator estimator(cfg);
+    MessageCorpus corpus(corpus_kind_from_env(), 64, corpus_seed_from_env(), 1);
+    string message;
     
-    while (total_bits < target_bits) {
-        string message = generate_random_message(64);
-        string hash = ac_hash(message, rule, steps);
-        
-        for (char c : hash) {
-            int value;
-            stringstream ss;
-            ss << hex << c;
-            ss >> value;
-            bitset<4> nibble(value);
-            for (int i = 3; i >= 0; --i) {
-                if (nibble[i]) total_ones++;
-            }
-        }
-        total_bits += hash.length() * 4;
+    while (!estimator.done()) {
+        message.assign(corpus.next());
+        Digest256 hash = ac_hash_digest(message, rule, steps);
+        estimator.add(digest_ones(hash) * 100.0 / DIGEST_BITS);
     }
     
-    return (total_ones * 100.0) / total_bits;
+    return estimator;
 }
 
 double test_execution_time(uint32_t rule, size_t steps, size_t num_hashes = 1000) {
-    vector<string> test_messages;
-    for (size_t i = 0; i < num_hashes; ++i) {
-        test_messages.push_back(generate_random_message(64));
-    }
+    TRACE_SCOPE_ARG("test_execution_time", "rule", rule);
+    MessageCorpus corpus(corpus_kind_from_env(), 64, corpus_seed_from_env(), 2);
+    corpus.fill(0, num_hashes);
+    string message;
     
     auto start = high_resolution_clock::now();
     
-    for (const string& message : test_messages) {
+    for (size_t i = 0; i < corpus.size(); ++i) {
+        message.assign(corpus[i]);
         ac_hash(message, rule, steps);
     }
     
@@ -225,15 +110,267 @@ void print_rule_info(uint32_t rule) {
     cout << endl;
 }
 
-int main() {
+// ==================== BALAYAGE DES 256 REGLES ====================
+//
+// Chaque tache (regle, etapes) est prise dans une file partagee (compteur
+// atomique) par un pool de threads. Les messages sont les memes pour toutes
+// les regles (generateur a compteur) et sont haches par lots de 64 avec le
+// noyau bit-slice. Une regle est abandonnee des le premier lot si elle est
+// degeneree (sortie constante, aucune diffusion, bits tres desequilibres).
+
+const size_t SWEEP_MESSAGE_LENGTH = 64;
+
+struct SweepResult {
+    uint32_t rule = 0;
+    size_t steps = 0;
+    size_t samples = 0;
+    double avalanche = 0;     // % de bits changes apres inversion d'un bit
+    double balance = 0;       // % de 1 dans les empreintes
+    double nsPerHash = 0;
+    string degenerate;        // vide si la regle a ete evaluee entierement
+
+    double deviation() const { return fabs(50.0 - avalanche) + fabs(50.0 - balance); }
+};
+
+SweepResult sweep_rule(uint32_t rule, size_t steps, const AvalancheConfig &cfg) {
+    TRACE_SCOPE_ARG("sweep_rule", "rule", rule);
+    SweepResult r;
+    r.rule = rule;
+    r.steps = steps;
+
+    string originals[ACHASH_LANES], modified[ACHASH_LANES];
+    Digest256 h0[ACHASH_LANES], h1[ACHASH_LANES];
+    uint64_t distance = 0, ones = 0;
+    double seconds = 0;
+
+    for (size_t first = 0; first < cfg.messages; first += ACHASH_LANES) {
+        size_t count = min(ACHASH_LANES, cfg.messages - first);
+        for (size_t i = 0; i < count; i++) {
+            avalanche_message(cfg, first + i, originals[i]);
+            modified[i] = originals[i];
+            uint64_t bit = CounterRng(cfg.seed, first + i).at(cfg.messageLength) % (8 * cfg.messageLength);
+            modified[i][bit / 8] ^= static_cast<char>(1 << (bit % 8));
+        }
+
+        auto start = steady_clock::now();
+        ac_hash_digest_batch(originals, count, rule, steps, h0);
+        ac_hash_digest_batch(modified, count, rule, steps, h1);
+        seconds += duration<double>(steady_clock::now() - start).count();
+
+        for (size_t i = 0; i < count; i++) {
+            distance += digest_hamming(h0[i], h1[i]);
+            ones += digest_ones(h0[i]);
+        }
+        r.samples += count;
+
+        if (first == 0) {
+            bool constant = true;
+            for (size_t i = 1; i < count && constant; i++) constant = (h0[i] == h0[0]);
+            double ratio = (double)ones / (count * DIGEST_BITS);
+            if (count > 1 && constant) r.degenerate = "constante";
+            else if (distance == 0) r.degenerate = "sans diffusion";
+            else if (ratio < 0.05 || ratio > 0.95) r.degenerate = "desequilibree";
+            if (!r.degenerate.empty()) break;
+        }
+    }
+
+    r.avalanche = distance * 100.0 / (r.samples * DIGEST_BITS);
+    r.balance = ones * 100.0 / (r.samples * DIGEST_BITS);
+    r.nsPerHash = seconds * 1e9 / (2 * r.samples);
+    return r;
+}
+
+// Regles evaluees d'abord, puis deviation croissante, puis vitesse
+bool sweep_better(const SweepResult &a, const SweepResult &b) {
+    if (a.degenerate.empty() != b.degenerate.empty()) return a.degenerate.empty();
+    if (a.deviation() != b.deviation()) return a.deviation() < b.deviation();
+    return a.nsPerHash < b.nsPerHash;
+}
+
+void write_sweep_csv(const string &path, const vector<SweepResult> &results) {
+    ofstream out(path);
+    out << "rang,regle,etapes,echantillons,avalanche,equilibre,deviation,ns_hash,degeneree\n";
+    out << fixed << setprecision(4);
+    for (size_t i = 0; i < results.size(); i++) {
+        const SweepResult &r = results[i];
+        out << i + 1 << ',' << r.rule << ',' << r.steps << ',' << r.samples << ',' << r.avalanche << ','
+            << r.balance << ',' << r.deviation() << ',' << r.nsPerHash << ',' << r.degenerate << '\n';
+    }
+}
+
+void write_sweep_json(const string &path, const vector<SweepResult> &results) {
+    ofstream out(path);
+    out << "[\n" << fixed << setprecision(4);
+    for (size_t i = 0; i < results.size(); i++) {
+        const SweepResult &r = results[i];
+        out << "  {\"rang\": " << i + 1 << ", \"regle\": " << r.rule << ", \"etapes\": " << r.steps
+            << ", \"echantillons\": " << r.samples << ", \"avalanche\": " << r.avalanche
+            << ", \"equilibre\": " << r.balance << ", \"deviation\": " << r.deviation()
+            << ", \"ns_hash\": " << r.nsPerHash << ", \"degeneree\": \"" << r.degenerate << "\"}"
+            << (i + 1 < results.size() ? "," : "") << '\n';
+    }
+    out << "]\n";
+}
+
+vector<size_t> parse_steps(const string &s) {
+    vector<size_t> out;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty()) out.push_back(stoul(item));
+    return out;
+}
+
+// Usage : Exercice7 sweep [etapes ex: 1,3,10] [echantillons] [threads] [prefixe]
+int run_sweep(int argc, char **argv) {
+    vector<size_t> stepCounts = (argc > 2) ? parse_steps(argv[2]) : vector<size_t>{10};
+    AvalancheConfig cfg;
+    cfg.messages = (argc > 3) ? stoul(argv[3]) : 128;
+    cfg.messageLength = SWEEP_MESSAGE_LENGTH;
+    unsigned threads = (argc > 4) ? static_cast<unsigned>(stoul(argv[4])) : thread::hardware_concurrency();
+    string prefix = (argc > 5) ? argv[5] : "rule_sweep";
+    if (threads == 0) threads = 1;
+    if (stepCounts.empty() || cfg.messages == 0) {
+        cerr << "Usage: Exercice7 sweep [etapes ex: 1,3,10] [echantillons>0] [threads] [prefixe]" << endl;
+        return 1;
+    }
+
+    cout << "=== BALAYAGE DES 256 REGLES ELEMENTAIRES ===" << endl;
+    cout << "Echantillons par regle: " << cfg.messages << " messages de " << cfg.messageLength
+         << " octets, threads: " << threads << endl << endl;
+
+    vector<SweepResult> results(256 * stepCounts.size());
+    atomic<size_t> next{0};
+    auto start = steady_clock::now();
+
+    auto worker = [&] {
+        for (;;) {
+            size_t task = next.fetch_add(1, memory_order_relaxed);
+            if (task >= results.size()) break;
+            results[task] = sweep_rule(static_cast<uint32_t>(task % 256), stepCounts[task / 256], cfg);
+        }
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (thread &th : pool) th.join();
+
+    double seconds = duration<double>(steady_clock::now() - start).count();
+    sort(results.begin(), results.end(), sweep_better);
+
+    size_t degenerate = 0;
+    for (const SweepResult &r : results) if (!r.degenerate.empty()) degenerate++;
+
+    cout << fixed << setprecision(2);
+    cout << left << setw(6) << "Rang" << setw(7) << "Regle" << setw(8) << "Etapes" << right
+         << setw(12) << "Avalanche%" << setw(12) << "Equilibre%" << setw(11) << "Deviation" << setw(10) << "ns/hash" << endl;
+    for (size_t i = 0; i < results.size() && i < 10; i++) {
+        const SweepResult &r = results[i];
+        cout << left << setw(6) << i + 1 << setw(7) << r.rule << setw(8) << r.steps << right
+             << setw(12) << r.avalanche << setw(12) << r.balance << setw(11) << r.deviation()
+             << setw(10) << r.nsPerHash << endl;
+    }
+    cout << "\nConfigurations evaluees: " << results.size() << " (" << degenerate
+         << " degenerees, arretees apres le premier lot)" << endl;
+    cout << "Duree totale: " << seconds * 1000 << " ms" << endl;
+
+    write_sweep_csv(prefix + ".csv", results);
+    write_sweep_json(prefix + ".json", results);
+    cout << "Classement ecrit dans " << prefix << ".csv et " << prefix << ".json" << endl;
+    return 0;
+}
+
+// ==================== COURBE QUALITE / NOMBRE D'ETAPES ====================
+//
+// Messages d'un seul bloc (16 octets) : ac_hash_step_sweep fait une seule
+// evolution par lot de 64 messages et finalise une copie de l'etat a chaque
+// nombre d'etapes, au lieu d'un hachage complet par nombre d'etapes.
+
+const size_t STEP_SWEEP_MESSAGE_LENGTH = 16;
+
+// Usage : Exercice7 steps [ac|plus] [regle] [etapes max] [echantillons] [prefixe]
+int run_step_sweep(int argc, char **argv) {
+    string variant = (argc > 2) ? argv[2] : "ac";
+    uint32_t rule = (argc > 3) ? static_cast<uint32_t>(stoul(argv[3])) : 110;
+    size_t maxSteps = (argc > 4) ? stoul(argv[4]) : 200;
+    size_t samples = (argc > 5) ? stoul(argv[5]) : 256;
+    string prefix = (argc > 6) ? argv[6] : "step_sweep";
+    if ((variant != "ac" && variant != "plus") || maxSteps == 0 || samples == 0) {
+        cerr << "Usage: Exercice7 steps [ac|plus] [regle] [etapes max>0] [echantillons>0] [prefixe]" << endl;
+        return 1;
+    }
+
+    cout << "=== COURBE QUALITE / NOMBRE D'ETAPES (" << (variant == "plus" ? "AC-Hash+" : "AC_HASH")
+         << ", regle " << rule << ") ===" << endl;
+    cout << "Etapes 1.." << maxSteps << ", " << samples << " paires de messages de "
+         << STEP_SWEEP_MESSAGE_LENGTH << " octets" << endl << endl;
+
+    vector<size_t> stepCounts;
+    for (size_t k = 1; k <= maxSteps; k++) stepCounts.push_back(k);
+
+    MessageCorpus corpus(corpus_kind_from_env(), STEP_SWEEP_MESSAGE_LENGTH, corpus_seed_from_env(), 0);
+    vector<RunningStats> avalanche(maxSteps), balance(maxSteps);
+    string originals[ACHASH_LANES], modified[ACHASH_LANES];
+    vector<Digest256> h0(maxSteps * ACHASH_LANES), h1(maxSteps * ACHASH_LANES);
+
+    auto start = steady_clock::now();
+    for (size_t first = 0; first < samples; first += ACHASH_LANES) {
+        TRACE_SCOPE_ARG("step_sweep_batch", "first", first);
+        size_t count = min(ACHASH_LANES, samples - first);
+        for (size_t i = 0; i < count; i++) {
+            originals[i].assign(corpus.next());
+            modified[i] = originals[i];
+            flip_random_bit(modified[i], corpus.rng());
+        }
+        if (variant == "plus") {
+            ac_hash_plus_step_sweep(originals, count, rule, stepCounts.data(), maxSteps, h0.data());
+            ac_hash_plus_step_sweep(modified, count, rule, stepCounts.data(), maxSteps, h1.data());
+        } else {
+            ac_hash_step_sweep(originals, count, rule, stepCounts.data(), maxSteps, h0.data());
+            ac_hash_step_sweep(modified, count, rule, stepCounts.data(), maxSteps, h1.data());
+        }
+        for (size_t k = 0; k < maxSteps; k++)
+            for (size_t i = 0; i < count; i++) {
+                avalanche[k].add(digest_hamming(h0[k * count + i], h1[k * count + i]) * 100.0 / DIGEST_BITS);
+                balance[k].add(digest_ones(h0[k * count + i]) * 100.0 / DIGEST_BITS);
+            }
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    ofstream csv(prefix + ".csv");
+    csv << "etapes,avalanche,avalanche_ic99,equilibre,equilibre_ic99\n" << fixed << setprecision(4);
+    double z = normal_quantile_two_sided(0.99);
+    cout << fixed << setprecision(2);
+    cout << left << setw(8) << "Etapes" << right << setw(14) << "Avalanche%" << setw(10) << "+/-"
+         << setw(14) << "Equilibre%" << setw(10) << "+/-" << endl;
+    for (size_t k = 0; k < maxSteps; k++) {
+        double aHalf = z * avalanche[k].standardError(), bHalf = z * balance[k].standardError();
+        csv << stepCounts[k] << ',' << avalanche[k].mean() << ',' << aHalf << ',' << balance[k].mean() << ',' << bHalf << '\n';
+        if (k < 10 || (k + 1) % 10 == 0)
+            cout << left << setw(8) << stepCounts[k] << right << setw(14) << avalanche[k].mean() << setw(10) << aHalf
+                 << setw(14) << balance[k].mean() << setw(10) << bHalf << endl;
+    }
+    cout << "\nDuree: " << seconds * 1000 << " ms (" << samples * 2 << " messages x " << maxSteps
+         << " nombres d'etapes)" << endl;
+    cout << "Courbe complete ecrite dans " << prefix << ".csv" << endl;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && string(argv[1]) == "sweep") return run_sweep(argc, argv);
+    if (argc > 1 && string(argv[1]) == "steps") return run_step_sweep(argc, argv);
+
     const size_t STEPS = 10;
-    const size_t NUM_TESTS = 500;
+    // Classement : arret sur la seule largeur d'intervalle (pas de SPRT)
+    const SequentialConfig comparison = comparison_config();
     
     vector<uint32_t> rules = {30, 90, 110};
     
     cout << "=== COMPARAISON DES REGLES D'AUTOMATES CELLULAIRES ===" << endl;
-    cout << "Nombre de tests par regle: " << NUM_TESTS << endl;
-    cout << "Nombre d'etapes: " << STEPS << endl << endl;
+    cout << "Nombre de tests par regle: au plus " << comparison.maxSamples << " (arret a +/- "
+         << comparison.tolerance << "% a 99%)" << endl;
+    cout << "Nombre d'etapes: " << STEPS << endl;
+    cout << "Corpus: " << corpus_kind_name(corpus_kind_from_env()) << ", graine " << corpus_seed_from_env() << endl << endl;
     
     // Informations sur les règles
     for (uint32_t rule : rules) {
@@ -244,6 +381,8 @@ int main() {
     vector<double> avalanche_results;
     vector<double> distribution_results;
     vector<double> time_results;
+    vector<SequentialEstimator> avalanche_estimators;
+    vector<SequentialEstimator> distribution_estimators;
     
     cout << "Execution des tests..." << endl;
     cout << "=========================================" << endl;
@@ -252,12 +391,14 @@ int main() {
         cout << "\nTest de la regle " << rule << " en cours..." << endl;
         
         // Test d'effet avalanche
-        double avalanche = test_avalanche_effect(rule, STEPS, NUM_TESTS);
-        avalanche_results.push_back(avalanche);
+        SequentialEstimator avalanche = test_avalanche_effect(rule, STEPS, comparison);
+        avalanche_results.push_back(avalanche.mean());
+        avalanche_estimators.push_back(avalanche);
         
         // Test de distribution
-        double distribution = test_bit_distribution(rule, STEPS, 50000);
-        distribution_results.push_back(distribution);
+        SequentialEstimator distribution = test_bit_distribution(rule, STEPS, comparison);
+        distribution_results.push_back(distribution.mean());
+        distribution_estimators.push_back(distribution);
         
         // Test de performance
         double execution_time = test_execution_time(rule, STEPS, 1000);
@@ -275,8 +416,8 @@ int main() {
     
     for (size_t i = 0; i < rules.size(); ++i) {
         cout << "\n--- Regle " << rules[i] << " ---" << endl;
-        cout << "Effet avalanche: " << avalanche_results[i] << "% (ideal: 50%)" << endl;
-        cout << "Distribution des bits: " << distribution_results[i] << "% de 1 (ideal: 50%)" << endl;
+        cout << "Effet avalanche: " << avalanche_estimators[i].summary() << " (ideal: 50%)" << endl;
+        cout << "Distribution des bits: " << distribution_estimators[i].summary() << " de 1 (ideal: 50%)" << endl;
         cout << "Temps d'execution: " << time_results[i] << " ms pour 1000 hachages" << endl;
         cout << "Deviation avalanche: " << abs(50.0 - avalanche_results[i]) << "%" << endl;
         cout << "Deviation distribution: " << abs(50.0 - distribution_results[i]) << "%" << endl;
@@ -287,9 +428,9 @@ int main() {
     cout << "ANALYSE COMPARATIVE" << endl;
     cout << "=========================================" << endl;
     
-    // Trouver la meilleure règle basée sur les critères combinés
-    double best_score = 0;
-    int best_rule_index = 0;
+    // Trouver la meilleure règle basée sur les critères combinés ; marge du
+    // score = incertitude (99%) des deux moyennes, le temps etant pris comme exact
+    vector<double> scores, margins;
     
     for (size_t i = 0; i < rules.size(); ++i) {
         // Score basé sur la qualité (avalanche + distribution) et la performance
@@ -298,36 +439,44 @@ int main() {
         double performance_score = 1000.0 / time_results[i]; // Plus rapide = meilleur score
         
         double total_score = avalanche_quality * 0.4 + distribution_quality * 0.4 + performance_score * 0.2;
+        double margin = (avalanche_estimators[i].halfWidth() + distribution_estimators[i].halfWidth()) * 10 * 0.4;
+        scores.push_back(total_score);
+        margins.push_back(margin);
         
-        cout << "Regle " << rules[i] << " - Score: " << total_score << endl;
-        
-        if (total_score > best_score) {
-            best_score = total_score;
-            best_rule_index = i;
-        }
+        cout << "Regle " << rules[i] << " - Score: " << total_score << " +/- " << margin << endl;
     }
     
-    cout << "\n REGLE RECOMMANDEE: " << rules[best_rule_index] << "" << endl;
-    cout << "Pourquoi:" << endl;
-    
-    switch(rules[best_rule_index]) {
-        case 30:
-            cout << "- Excellente propriete d'avalanche (" << avalanche_results[best_rule_index] << "%)" << endl;
-            cout << "- Distribution équilibree (" << distribution_results[best_rule_index] << "% de 1)" << endl;
-            cout << "- Comportement chaotique ideal pour la cryptographie" << endl;
-            cout << "- Performance correcte" << endl;
-            break;
-        case 90:
-            cout << "- Performance la plus rapide (" << time_results[best_rule_index] << " ms)" << endl;
-            cout << "- Distribution acceptable (" << distribution_results[best_rule_index] << "% de 1)" << endl;
-            cout << "- Structure mathematique simple mais moins securisee" << endl;
-            break;
-        case 110:
-            cout << "- Meilleur equilibre securite/performance" << endl;
-            cout << "- Bon effet avalanche (" << avalanche_results[best_rule_index] << "%)" << endl;
-            cout << "- Distribution quasi-parfaite (" << distribution_results[best_rule_index] << "% de 1)" << endl;
-            cout << "- Automate universel avec proprietes cryptographiques solides" << endl;
-            break;
+    // Recommandation seulement si l'intervalle du meilleur score ne recoupe aucun autre
+    vector<size_t> tied;
+    int best = best_separated(scores, margins, tied);
+    if (best < 0) {
+        cout << "\n AUCUNE REGLE RECOMMANDEE: scores indiscernables (intervalles a 99% qui se recoupent) entre les regles";
+        for (size_t i : tied) cout << " " << rules[i];
+        cout << endl;
+    } else {
+        size_t best_rule_index = static_cast<size_t>(best);
+        cout << "\n REGLE RECOMMANDEE: " << rules[best_rule_index] << "" << endl;
+        cout << "Pourquoi:" << endl;
+        
+        switch(rules[best_rule_index]) {
+            case 30:
+                cout << "- Excellente propriete d'avalanche (" << avalanche_results[best_rule_index] << "%)" << endl;
+                cout << "- Distribution équilibree (" << distribution_results[best_rule_index] << "% de 1)" << endl;
+                cout << "- Comportement chaotique ideal pour la cryptographie" << endl;
+                cout << "- Performance correcte" << endl;
+                break;
+            case 90:
+                cout << "- Performance la plus rapide (" << time_results[best_rule_index] << " ms)" << endl;
+                cout << "- Distribution acceptable (" << distribution_results[best_rule_index] << "% de 1)" << endl;
+                cout << "- Structure mathematique simple mais moins securisee" << endl;
+                break;
+            case 110:
+                cout << "- Meilleur equilibre securite/performance" << endl;
+                cout << "- Bon effet avalanche (" << avalanche_results[best_rule_index] << "%)" << endl;
+                cout << "- Distribution quasi-parfaite (" << distribution_results[best_rule_index] << "% de 1)" << endl;
+                cout << "- Automate universel avec proprietes cryptographiques solides" << endl;
+                break;
+        }
     }
     
     // Test supplémentaire: collision sur un message spécifique
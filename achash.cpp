@@ -0,0 +1,999 @@
+#include "achash.h"
+#include "additive_rule.h"
+#include "cellular_automaton.h"
+#include "metrics.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+using namespace std;
+
+// ---------------------------- Utilitaires ----------------------------
+
+// Convertit une chaine en bits (un octet 0/1 par bit, MSB first par octet)
+static vector<uint8_t> string_to_bits(const string &s) {
+    vector<uint8_t> bits;
+    bits.reserve(s.size() * 8 + 512);
+    for (unsigned char uc : s)
+        for (int i = 7; i >= 0; --i)
+            bits.push_back((uc >> i) & 1);
+    return bits;
+}
+
+// Ajoute x sur 64 bits big-endian (MSB first)
+static void append_u64_be(vector<uint8_t> &bits, uint64_t x) {
+    for (int i = 63; i >= 0; --i)
+        bits.push_back((x >> i) & 1);
+}
+
+// Ordre des bits d'un octet en entree : AC_HASH (MSB first) et AC-Hash+ (permute)
+static const int AC_BIT_ORDER[8] = {7, 6, 5, 4, 3, 2, 1, 0};
+static const int PLUS_BIT_ORDER[8] = {2, 5, 0, 7, 1, 4, 3, 6};
+
+// AC_HASH : bits MSB first + 1 + zeros + longueur 64 bits (blocs de 256)
+static vector<uint8_t> ac_padded_bits(const string &input) {
+    vector<uint8_t> input_bits = string_to_bits(input);
+    size_t original_size = input_bits.size();
+    input_bits.push_back(1);
+    while ((input_bits.size() + 64) % 256 != 0)
+        input_bits.push_back(0);
+    append_u64_be(input_bits, original_size);
+    return input_bits;
+}
+
+// AC-Hash+ : bits permutes + 1 + sel 32 bits + zeros + longueur (blocs de 512)
+static vector<uint8_t> plus_padded_bits(const string &input) {
+    vector<uint8_t> input_bits;
+    input_bits.reserve(input.size() * 8 + 1024);
+    for (unsigned char uc : input)
+        for (int idx : PLUS_BIT_ORDER)
+            input_bits.push_back((uc >> idx) & 1);
+
+    size_t original_size = input_bits.size();
+    input_bits.push_back(1);
+    size_t salt = original_size * 37;
+    for (int i = 0; i < 32; ++i)
+        input_bits.push_back((salt >> i) & 1);
+    while ((input_bits.size() + 64) % 512 != 0)
+        input_bits.push_back(0);
+    append_u64_be(input_bits, original_size);
+    return input_bits;
+}
+
+// Empaquette 256 cellules (0/1, MSB first) dans un Digest256
+static Digest256 cells_to_digest(const uint8_t *cells) {
+    Digest256 digest = {0, 0, 0, 0};
+    for (size_t i = 0; i < 256; ++i)
+        digest[i / 64] = (digest[i / 64] << 1) | (cells[i] & 1);
+    return digest;
+}
+
+string digest_to_hex(const Digest256 &digest) {
+    stringstream ss;
+    ss << hex << setfill('0');
+    for (uint64_t word : digest)
+        ss << setw(16) << word;
+    return ss.str();
+}
+
+// Sortie de la regle pour un voisinage (l, c, r) sans table indexee :
+// masks[p] vaut 0xFF si le bit p de la regle est a 1. Uniquement des
+// operations bit a bit, donc vectorisable par le compilateur.
+static inline uint8_t rule_select(const uint8_t masks[8], uint8_t l, uint8_t c, uint8_t r) {
+    uint8_t L = (uint8_t)-l, C = (uint8_t)-c, R = (uint8_t)-r;
+    uint8_t r0 = (uint8_t)((R & masks[1]) | (~R & masks[0]));
+    uint8_t r1 = (uint8_t)((R & masks[3]) | (~R & masks[2]));
+    uint8_t r2 = (uint8_t)((R & masks[5]) | (~R & masks[4]));
+    uint8_t r3 = (uint8_t)((R & masks[7]) | (~R & masks[6]));
+    uint8_t c0 = (uint8_t)((C & r1) | (~C & r0));
+    uint8_t c1 = (uint8_t)((C & r3) | (~C & r2));
+    return (uint8_t)(((L & c1) | (~L & c0)) & 1);
+}
+
+static inline void rule_masks(uint32_t rule, uint8_t masks[8]) {
+    for (int p = 0; p < 8; ++p)
+        masks[p] = ((rule >> p) & 1) ? 0xFF : 0x00;
+}
+
+// ---------------------- Automate cellulaire (r = 1) --------------------
+
+// 1.1 - Initialise l'etat a partir d'un vecteur de bits
+vector<int> init_state(const vector<int> &initial_bits) {
+    return initial_bits;
+}
+
+// Convertit la regle en tableau binaire (rule_bits[7 - p] = sortie du motif p)
+vector<int> rule_to_binary(int rule_number) {
+    vector<int> rule_bits(8);
+    for (int i = 0; i < 8; ++i) {
+        rule_bits[7 - i] = (rule_number >> i) & 1;
+    }
+    return rule_bits;
+}
+
+// 1.2 - evolve() : applique une regle sur tout le vecteur (bord periodique)
+vector<int> evolve(const vector<int> &state, int rule_number) {
+    int n = state.size();
+    vector<int> next_state(n, 0);
+    vector<int> rule_bits = rule_to_binary(rule_number);
+
+    for (int i = 0; i < n; ++i) {
+        int left   = (i == 0) ? state[n - 1] : state[i - 1];
+        int center = state[i];
+        int right  = (i == n - 1) ? state[0] : state[i + 1];
+
+        int pattern = (left << 2) | (center << 1) | right;
+        next_state[i] = rule_bits[7 - pattern];
+    }
+    return next_state;
+}
+
+// ------------------------ Noyaux (multiversion) -----------------------
+
+// AC_HASH de base : regle fixe, donc automate du moteur generique construit
+// une fois par regle, avec sa LUT multi-generations (4 generations par
+// consultation). Raccourci booleen pour les regles additives (90, 150...) :
+// XOR des mots decales, plus court qu'une consultation de table.
+struct BasicRule {
+    ElementaryAutomaton ca;
+    AdditiveRule<1> additive;
+};
+
+static const BasicRule &basic_rule(uint32_t rule) {
+    static once_flag once[256];
+    static unique_ptr<BasicRule> rules[256];
+    const uint32_t r = rule & 255;
+    call_once(once[r], [r] {
+        rules[r].reset(new BasicRule{ElementaryAutomaton::from_number(r), AdditiveRule<1>::from_number(r)});
+    });
+    return *rules[r];
+}
+
+// 'steps' evolutions periodiques de 256 cellules empaquetees (cellule i =
+// bit i & 63 du mot i >> 6)
+static void basic_packed_steps(uint64_t s[4], const BasicRule &rule, size_t steps) {
+    const size_t K = ElementaryAutomaton::multi_steps;
+    const uint32_t xor_mask = rule.additive.mask();
+    const uint64_t complement = rule.additive.complement() ? ~0ULL : 0;
+    uint64_t ext[6];
+    for (size_t done = 0; done < steps;) {
+        ext[0] = s[3];
+        memcpy(ext + 1, s, 4 * sizeof(uint64_t));
+        ext[5] = s[0];
+        if (rule.additive.valid()) {
+            // bit 2 : voisin de gauche (cellule i - 1), bit 0 : voisin de droite
+            for (size_t w = 0; w < 4; ++w) {
+                uint64_t v = complement;
+                if (xor_mask & 4) v ^= (ext[w + 1] << 1) | (ext[w] >> 63);
+                if (xor_mask & 2) v ^= ext[w + 1];
+                if (xor_mask & 1) v ^= (ext[w + 1] >> 1) | (ext[w + 2] << 63);
+                s[w] = v;
+            }
+            ++done;
+        } else if (steps - done >= K) {
+            rule.ca.step_words_multi(ext, s, 4);
+            done += K;
+        } else {
+            rule.ca.step_words(ext, s, 4);
+            ++done;
+        }
+    }
+}
+
+// AC_HASH : regle dynamique par etape + melange state[(i*7 + step*13) % 256]
+ACHASH_MULTIVERSION
+static void ac_kernel_steps(uint8_t *state, uint32_t rule, size_t block, size_t steps) {
+    uint8_t masks[8];
+    uint8_t next[256];
+    for (size_t step = 0; step < steps; ++step) {
+        rule_masks((rule + step * 37 + block) % 256, masks);
+        next[0] = rule_select(masks, state[255], state[0], state[1]);
+        for (size_t i = 1; i < 255; ++i)
+            next[i] = rule_select(masks, state[i - 1], state[i], state[i + 1]);
+        next[255] = rule_select(masks, state[254], state[255], state[0]);
+
+        size_t mix = step * 13;
+        for (size_t i = 0; i < 256; ++i)
+            next[i] ^= state[(i * 7 + mix) & 255];
+        memcpy(state, next, 256);
+    }
+}
+
+// AC_HASH : finalisation (10 etapes, melange state[(i*5 + k*11) % 256])
+ACHASH_MULTIVERSION
+static void ac_kernel_finalize(uint8_t *state, uint32_t rule) {
+    uint8_t masks[8];
+    rule_masks(rule, masks);
+    uint8_t next[256];
+    for (size_t k = 0; k < 10; ++k) {
+        next[0] = rule_select(masks, state[255], state[0], state[1]);
+        for (size_t i = 1; i < 255; ++i)
+            next[i] = rule_select(masks, state[i - 1], state[i], state[i + 1]);
+        next[255] = rule_select(masks, state[254], state[255], state[0]);
+
+        for (size_t i = 0; i < 256; ++i)
+            next[i] ^= state[(i * 5 + k * 11) & 255];
+        memcpy(state, next, 256);
+    }
+}
+
+// AC-Hash+ : regle dynamique dependant de l'etat, voisinage 3/5/7 cellules.
+// 'pattern % 8' ne garde que les 3 dernieres cellules du voisinage :
+// (i-1, i, i+1) pour 3, (i, i+1, i+2) pour 5, (i+1, i+2, i+3) pour 7.
+ACHASH_MULTIVERSION
+static void plus_kernel_steps(uint8_t *state, uint32_t base_rule, size_t block, size_t steps) {
+    uint8_t masks[8];
+    uint8_t next[512];
+    for (size_t step = 0; step < steps; ++step) {
+        uint32_t state_hash = 0;
+        for (size_t j = 0; j < 32; ++j)
+            if (state[j * 16]) state_hash |= (1u << j);
+        rule_masks((base_rule + step * 37 + block + state_hash) % 256, masks);
+
+        size_t shift = step % 3; // premiere cellule retenue : i - 1 + shift
+        for (size_t i = 0; i < 512; ++i) {
+            size_t a = (i + 511 + shift) & 511;
+            next[i] = rule_select(masks, state[a], state[(a + 1) & 511], state[(a + 2) & 511]);
+        }
+
+        for (size_t i = 0; i < 512; ++i)
+            next[i] ^= state[(i * 7 + step * 13) & 511] ^ state[(i * 11 + step * 17) & 511];
+        memcpy(state, next, 512);
+    }
+}
+
+// AC-Hash+ : finalisation (20 etapes, voisinage 5 cellules, regle 32 bits)
+ACHASH_MULTIVERSION
+static void plus_kernel_finalize(uint8_t *state, uint32_t base_rule) {
+    uint8_t next[512];
+    for (size_t k = 0; k < 20; ++k) {
+        for (size_t i = 0; i < 512; ++i) {
+            uint32_t pattern = (state[(i + 510) & 511] << 4) | (state[(i + 511) & 511] << 3) |
+                               (state[i] << 2) | (state[(i + 1) & 511] << 1) | state[(i + 2) & 511];
+            next[i] = ((base_rule >> pattern) & 1) ^ state[(i * 7 + k * 19) & 511];
+        }
+        memcpy(state, next, 512);
+    }
+}
+
+// ------------------- Noyaux bit-slices (64 lanes) ---------------------
+//
+// Meme calcul que les noyaux ci-dessus, mais chaque cellule est un mot de
+// 64 bits dont le bit l appartient au message l. La regle est choisie par
+// un arbre de multiplexeurs sur des masques de lanes.
+
+// Circuit r = 1 du moteur generique (cellular_automaton.h)
+static inline uint64_t lane_select(const uint64_t masks[8], uint64_t L, uint64_t C, uint64_t R) {
+    const uint64_t x[3] = {L, C, R};
+    return ca_circuit<3>(masks, x);
+}
+
+static inline void lane_masks(uint32_t rule, uint64_t masks[8]) {
+    for (int p = 0; p < 8; ++p)
+        masks[p] = ((rule >> p) & 1) ? ~0ULL : 0ULL;
+}
+
+// Etapes first_step .. first_step + steps - 1 (reprise d'une evolution)
+ACHASH_MULTIVERSION
+static void ac_lanes_steps(uint64_t *state, uint32_t rule, size_t block, size_t steps, size_t first_step = 0) {
+    uint64_t masks[8];
+    uint64_t next[256];
+    for (size_t step = first_step; step < first_step + steps; ++step) {
+        lane_masks((rule + step * 37 + block) % 256, masks);
+        next[0] = lane_select(masks, state[255], state[0], state[1]);
+        for (size_t i = 1; i < 255; ++i)
+            next[i] = lane_select(masks, state[i - 1], state[i], state[i + 1]);
+        next[255] = lane_select(masks, state[254], state[255], state[0]);
+
+        size_t mix = step * 13;
+        for (size_t i = 0; i < 256; ++i)
+            next[i] ^= state[(i * 7 + mix) & 255];
+        memcpy(state, next, sizeof(next));
+    }
+}
+
+ACHASH_MULTIVERSION
+static void ac_lanes_finalize(uint64_t *state, uint32_t rule) {
+    uint64_t masks[8];
+    lane_masks(rule, masks);
+    uint64_t next[256];
+    for (size_t k = 0; k < 10; ++k) {
+        next[0] = lane_select(masks, state[255], state[0], state[1]);
+        for (size_t i = 1; i < 255; ++i)
+            next[i] = lane_select(masks, state[i - 1], state[i], state[i + 1]);
+        next[255] = lane_select(masks, state[254], state[255], state[0]);
+
+        for (size_t i = 0; i < 256; ++i)
+            next[i] ^= state[(i * 5 + k * 11) & 255];
+        memcpy(state, next, sizeof(next));
+    }
+}
+
+// La regle depend de l'etat de chaque lane : seuls les 8 bits de poids
+// faible de state_hash comptent (% 256), soit les cellules 0, 16, ..., 112.
+// L'addition de la constante est faite en bit-slice (additionneur a retenue).
+ACHASH_MULTIVERSION
+static void plus_lanes_steps(uint64_t *state, uint32_t base_rule, size_t block, size_t steps, size_t first_step = 0) {
+    uint64_t masks[8];
+    uint64_t next[512];
+    for (size_t step = first_step; step < first_step + steps; ++step) {
+        uint32_t constant = (base_rule + step * 37 + block) % 256;
+        uint64_t carry = 0;
+        for (int p = 0; p < 8; ++p) {
+            uint64_t h = state[p * 16];
+            uint64_t c = ((constant >> p) & 1) ? ~0ULL : 0ULL;
+            masks[p] = h ^ c ^ carry;
+            carry = (h & c) | (carry & (h ^ c));
+        }
+
+        size_t shift = step % 3;
+        for (size_t i = 0; i < 512; ++i) {
+            size_t a = (i + 511 + shift) & 511;
+            next[i] = lane_select(masks, state[a], state[(a + 1) & 511], state[(a + 2) & 511]);
+        }
+
+        for (size_t i = 0; i < 512; ++i)
+            next[i] ^= state[(i * 7 + step * 13) & 511] ^ state[(i * 11 + step * 17) & 511];
+        memcpy(state, next, sizeof(next));
+    }
+}
+
+ACHASH_MULTIVERSION
+static void plus_lanes_finalize(uint64_t *state, uint32_t base_rule) {
+    uint64_t masks[32];
+    for (int p = 0; p < 32; ++p)
+        masks[p] = ((base_rule >> p) & 1) ? ~0ULL : 0ULL;
+    uint64_t next[512];
+    for (size_t k = 0; k < 20; ++k) {
+        for (size_t i = 0; i < 512; ++i) {
+            // Motif 5 bits (i-2 .. i+2), i+2 = bit de poids faible : circuit r = 2
+            const uint64_t x[5] = {state[(i + 510) & 511], state[(i + 511) & 511], state[i],
+                                   state[(i + 1) & 511], state[(i + 2) & 511]};
+            next[i] = ca_circuit<5>(masks, x) ^ state[(i * 7 + k * 19) & 511];
+        }
+        memcpy(state, next, sizeof(next));
+    }
+}
+
+// ----------------- AC-Hash+ empaquete (8 x 64 bits, BMI2) -----------------
+//
+// Un seul message, 512 cellules dans 8 mots : cellule i = bit (i & 63) du
+// mot i >> 6. Les voisinages sont des copies decalees de l'etat (rotations
+// de mots), la regle est appliquee par lane_select sur 64 cellules a la fois,
+// et les deux melanges state[(i*m + c) % 512] deviennent une rotation de c
+// suivie d'une collecte fixe des cellules m*i (pext). Choisi a l'execution
+// si le CPU a AVX2 et BMI2 (les fonctions sont compilees pour les deux) et un
+// pext cable ; sinon plus_kernel_steps / plus_kernel_finalize. Sur AMD avant
+// Zen 3 (familles < 19h), pext est microcode (~250 cycles, ~160 par etape) :
+// le noyau octet par cellule y est plus rapide.
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define ACHASH_PACKED_PLUS 1
+#include <cpuid.h>
+#include <immintrin.h>
+
+// Collecte out[i] = in[(m * i) % 512] : pour chaque mot de sortie, liste de
+// segments (mot source, masque, decalage) dont les cellules sont croissantes
+struct StrideGather {
+    struct Segment {
+        uint64_t mask;
+        uint8_t source;
+        uint8_t shift;
+    };
+    Segment segments[8][16];
+    uint8_t counts[8];
+
+    explicit StrideGather(size_t m) {
+        for (size_t w = 0; w < 8; ++w) {
+            counts[w] = 0;
+            size_t previous = 512;
+            for (size_t j = 0; j < 64; ++j) {
+                size_t p = (m * (64 * w + j)) & 511;
+                if (previous == 512 || (p >> 6) != (previous >> 6) || p < previous) {
+                    assert(counts[w] < 16);
+                    segments[w][counts[w]++] = {0, static_cast<uint8_t>(p >> 6), static_cast<uint8_t>(j)};
+                }
+                segments[w][counts[w] - 1].mask |= 1ULL << (p & 63);
+                previous = p;
+            }
+        }
+    }
+};
+
+static const StrideGather GATHER_7(7);
+static const StrideGather GATHER_11(11);
+
+// out[i] = s[(i + c) % 512]
+static inline void packed_rotate(const uint64_t s[8], size_t c, uint64_t out[8]) {
+    size_t q = (c >> 6) & 7, r = c & 63;
+    for (size_t w = 0; w < 8; ++w)
+        out[w] = r ? (s[(w + q) & 7] >> r) | (s[(w + q + 1) & 7] << (64 - r)) : s[(w + q) & 7];
+}
+
+// out[i] ^= s[(m*i + c) % 512]
+__attribute__((target("avx2,bmi2")))
+static inline void packed_mix(const uint64_t s[8], const StrideGather &gather, size_t c, uint64_t out[8]) {
+    uint64_t rotated[8];
+    packed_rotate(s, c, rotated);
+    for (size_t w = 0; w < 8; ++w) {
+        uint64_t word = 0;
+        for (size_t k = 0; k < gather.counts[w]; ++k) {
+            const StrideGather::Segment &seg = gather.segments[w][k];
+            word |= _pext_u64(rotated[seg.source], seg.mask) << seg.shift;
+        }
+        out[w] ^= word;
+    }
+}
+
+__attribute__((target("avx2,bmi2"), flatten))
+static void plus_packed_steps(uint64_t s[8], uint32_t base_rule, size_t block, size_t steps) {
+    uint64_t masks[8], left[8], center[8], right[8], next[8];
+    for (size_t step = 0; step < steps; ++step) {
+        // Cellules 0, 16, ..., 496 : 4 par mot
+        uint32_t state_hash = 0;
+        for (size_t w = 0; w < 8; ++w)
+            state_hash |= static_cast<uint32_t>(_pext_u64(s[w], 0x0001000100010001ULL)) << (4 * w);
+        lane_masks((base_rule + step * 37 + block + state_hash) % 256, masks);
+
+        size_t shift = step % 3; // premiere cellule retenue : i - 1 + shift
+        packed_rotate(s, 511 + shift, left);
+        packed_rotate(s, shift, center);
+        packed_rotate(s, shift + 1, right);
+        for (size_t w = 0; w < 8; ++w)
+            next[w] = lane_select(masks, left[w], center[w], right[w]);
+
+        packed_mix(s, GATHER_7, step * 13, next);
+        packed_mix(s, GATHER_11, step * 17, next);
+        memcpy(s, next, sizeof(next));
+    }
+}
+
+__attribute__((target("avx2,bmi2"), flatten))
+static void plus_packed_finalize(uint64_t s[8], uint32_t base_rule) {
+    uint64_t masks[32];
+    for (int p = 0; p < 32; ++p)
+        masks[p] = ((base_rule >> p) & 1) ? ~0ULL : 0ULL;
+    uint64_t x[5][8], next[8];
+    for (size_t k = 0; k < 20; ++k) {
+        // x[d] : cellule i - 2 + d (x[0] = bit de poids fort du motif)
+        for (size_t d = 0; d < 5; ++d)
+            packed_rotate(s, 510 + d, x[d]);
+        for (size_t w = 0; w < 8; ++w) {
+            const uint64_t cells[5] = {x[0][w], x[1][w], x[2][w], x[3][w], x[4][w]};
+            next[w] = ca_circuit<5>(masks, cells);
+        }
+        packed_mix(s, GATHER_7, k * 19, next);
+        memcpy(s, next, sizeof(next));
+    }
+}
+
+// Inverse l'ordre des bits (cellule 0 en poids fort, comme cells_to_digest)
+static inline uint64_t reverse_bits64(uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return __builtin_bswap64(x);
+}
+
+// pext microcode : AMD de famille < 19h (Excavator, Zen 1, Zen 2)
+static bool slow_pext() {
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return false;
+    bool amd = ebx == 0x68747541 && edx == 0x69746e65 && ecx == 0x444d4163;   // "AuthenticAMD"
+    if (!amd || !__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+    unsigned family = (eax >> 8) & 0xF;
+    if (family == 0xF) family += (eax >> 20) & 0xFF;
+    return family < 0x19;
+}
+
+static bool plus_packed_available() {
+    static const bool available = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") &&
+                                   __builtin_cpu_supports("bmi2") && !slow_pext());
+    return available;
+}
+#endif
+
+// Transposition d'une matrice 64 x 64 bits : bit j de a[i] <-> bit i de a[j]
+static void transpose64(uint64_t a[64]) {
+    uint64_t m = 0x00000000FFFFFFFFULL;
+    for (int j = 32; j != 0; j >>= 1, m ^= (m << j)) {
+        for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+            uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+            a[k] ^= t << j;
+            a[k | j] ^= t;
+        }
+    }
+}
+
+/**
+ * Flux padde en mots de lanes : les bits de message sont transposes octet
+ * par octet, le padding (identique pour une longueur donnee) est diffuse.
+ */
+static vector<uint64_t> lanes_padded_words(const string *const *inputs, size_t count,
+                                           const vector<uint8_t> &padded, const int order[8]) {
+    vector<uint64_t> words(padded.size());
+    size_t len = inputs[0]->size();
+    for (size_t b = 0; b < len; ++b) {
+        uint64_t w[8] = {0};
+        for (size_t l = 0; l < count; ++l) {
+            unsigned x = static_cast<unsigned char>((*inputs[l])[b]);
+            for (int k = 0; k < 8; ++k)
+                w[k] |= static_cast<uint64_t>((x >> order[k]) & 1) << l;
+        }
+        memcpy(&words[8 * b], w, sizeof(w));
+    }
+    for (size_t i = 8 * len; i < padded.size(); ++i)
+        words[i] = padded[i] ? ~0ULL : 0ULL;
+    return words;
+}
+
+static void ac_lanes(const string *const *inputs, size_t count, uint32_t rule, size_t steps, uint64_t sliced[256]) {
+    vector<uint64_t> words = lanes_padded_words(inputs, count, ac_padded_bits(*inputs[0]), AC_BIT_ORDER);
+    uint64_t state[256] = {0};
+    for (size_t block = 0; block < words.size(); block += 256) {
+        for (size_t i = 0; i < 256; ++i)
+            state[i] ^= words[block + i];
+        ac_lanes_steps(state, rule, block, steps);
+    }
+    ac_lanes_finalize(state, rule);
+    memcpy(sliced, state, sizeof(state));
+}
+
+static void plus_lanes(const string *const *inputs, size_t count, uint32_t base_rule, size_t steps, uint64_t sliced[256]) {
+    vector<uint64_t> words = lanes_padded_words(inputs, count, plus_padded_bits(*inputs[0]), PLUS_BIT_ORDER);
+    uint64_t state[512] = {0};
+    for (size_t block = 0; block < words.size(); block += 512) {
+        for (size_t i = 0; i < 512; ++i)
+            state[(i * 3) & 511] ^= words[block + i];
+        plus_lanes_steps(state, base_rule, block, steps);
+    }
+    plus_lanes_finalize(state, base_rule);
+    for (size_t i = 0; i < 256; ++i)
+        sliced[i] = state[i] ^ state[i + 256];
+}
+
+// Cellules bit-slicees -> une empreinte par lane
+static void sliced_to_digests(const uint64_t sliced[256], size_t count, Digest256 *out) {
+    uint64_t rows[4][64];
+    for (int w = 0; w < 4; ++w) {
+        for (int m = 0; m < 64; ++m)
+            rows[w][m] = sliced[64 * w + 63 - m];
+        transpose64(rows[w]);
+    }
+    for (size_t l = 0; l < count; ++l)
+        for (int w = 0; w < 4; ++w)
+            out[l][w] = rows[w][l];
+}
+
+// Regroupe les messages par longueur (<= 64 par lot) et hache chaque lot
+template <typename LanesFn>
+static void batch_by_length(const string *inputs, size_t count, Digest256 *out, LanesFn lanes) {
+    vector<bool> done(count, false);
+    const string *group[ACHASH_LANES];
+    size_t index[ACHASH_LANES];
+    uint64_t sliced[256];
+    Digest256 digests[ACHASH_LANES];
+    for (size_t first = 0; first < count; ++first) {
+        if (done[first]) continue;
+        size_t n = 0;
+        for (size_t i = first; i < count && n < ACHASH_LANES; ++i) {
+            if (done[i] || inputs[i].size() != inputs[first].size()) continue;
+            group[n] = &inputs[i];
+            index[n++] = i;
+            done[i] = true;
+        }
+        lanes(group, n, sliced);
+        sliced_to_digests(sliced, n, digests);
+        for (size_t k = 0; k < n; ++k)
+            out[index[k]] = digests[k];
+    }
+}
+
+// ---------------- Balayage du nombre d'etapes (un seul bloc) ----------------
+//
+// Pour un message d'un seul bloc, les etapes 0..k-1 sont les memes quel que
+// soit le nombre total d'etapes : l'etat apres k etapes est un prefixe de
+// l'evolution a k + 1 etapes. Une seule evolution par lot de 64 messages,
+// et une copie de l'etat est finalisee a chaque nombre d'etapes demande.
+
+static const size_t AC_SINGLE_BLOCK_BYTES = (256 - 1 - 64) / 8;          // 23
+static const size_t PLUS_SINGLE_BLOCK_BYTES = (512 - 1 - 32 - 64) / 8;   // 51
+
+// order : index des nombres d'etapes tries par valeur croissante
+static void ac_lanes_sweep(const string *const *inputs, size_t count, uint32_t rule, const size_t *step_counts,
+                           const vector<size_t> &order, uint64_t (*sliced)[256]) {
+    vector<uint64_t> words = lanes_padded_words(inputs, count, ac_padded_bits(*inputs[0]), AC_BIT_ORDER);
+    uint64_t state[256], snapshot[256];
+    memcpy(state, words.data(), sizeof(state));
+    size_t done = 0;
+    for (size_t k : order) {
+        ac_lanes_steps(state, rule, 0, step_counts[k] - done, done);
+        done = step_counts[k];
+        memcpy(snapshot, state, sizeof(state));
+        ac_lanes_finalize(snapshot, rule);
+        memcpy(sliced[k], snapshot, sizeof(snapshot));
+    }
+}
+
+static void plus_lanes_sweep(const string *const *inputs, size_t count, uint32_t base_rule, const size_t *step_counts,
+                             const vector<size_t> &order, uint64_t (*sliced)[256]) {
+    vector<uint64_t> words = lanes_padded_words(inputs, count, plus_padded_bits(*inputs[0]), PLUS_BIT_ORDER);
+    uint64_t state[512] = {0}, snapshot[512];
+    for (size_t i = 0; i < 512; ++i)
+        state[(i * 3) & 511] ^= words[i];
+    size_t done = 0;
+    for (size_t k : order) {
+        plus_lanes_steps(state, base_rule, 0, step_counts[k] - done, done);
+        done = step_counts[k];
+        memcpy(snapshot, state, sizeof(state));
+        plus_lanes_finalize(snapshot, base_rule);
+        for (size_t i = 0; i < 256; ++i)
+            sliced[k][i] = snapshot[i] ^ snapshot[i + 256];
+    }
+}
+
+/**
+ * Regroupe les messages par longueur comme batch_by_length ; les messages
+ * de plus d'un bloc n'ont pas de prefixe commun et sont haches un par un.
+ */
+template <typename SweepFn, typename DigestFn>
+static void sweep_by_length(const string *inputs, size_t count, const size_t *step_counts, size_t num_counts,
+                            size_t max_bytes, Digest256 *out, SweepFn sweep, DigestFn digest) {
+    vector<size_t> order(num_counts);
+    for (size_t k = 0; k < num_counts; ++k) order[k] = k;
+    stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return step_counts[a] < step_counts[b]; });
+
+    vector<bool> done(count, false);
+    const string *group[ACHASH_LANES];
+    size_t index[ACHASH_LANES];
+    vector<uint64_t> sliced(num_counts * 256);
+    Digest256 digests[ACHASH_LANES];
+    for (size_t first = 0; first < count; ++first) {
+        if (done[first]) continue;
+        if (inputs[first].size() > max_bytes) {
+            for (size_t k = 0; k < num_counts; ++k)
+                out[k * count + first] = digest(inputs[first], step_counts[k]);
+            done[first] = true;
+            continue;
+        }
+        size_t n = 0;
+        for (size_t i = first; i < count && n < ACHASH_LANES; ++i) {
+            if (done[i] || inputs[i].size() != inputs[first].size()) continue;
+            group[n] = &inputs[i];
+            index[n++] = i;
+            done[i] = true;
+        }
+        sweep(group, n, order, reinterpret_cast<uint64_t (*)[256]>(sliced.data()));
+        for (size_t k = 0; k < num_counts; ++k) {
+            sliced_to_digests(&sliced[k * 256], n, digests);
+            for (size_t j = 0; j < n; ++j)
+                out[k * count + index[j]] = digests[j];
+        }
+    }
+}
+
+// --------------------------- Fonctions de hachage ----------------------
+
+Digest256 ac_hash_basic_digest(const string &input, uint32_t rule, size_t steps) {
+    METRIC_ADD(METRIC_HASH_AC_BASIC, 1);
+
+    // 1) Conversion du message en bits
+    vector<uint8_t> padded = string_to_bits(input);
+    uint64_t original_len_bits = padded.size();
+
+    // 2) Padding (similaire a SHA)
+    padded.push_back(1);
+    size_t rem = ((original_len_bits + 1 + 64) % 256);
+    size_t k = (rem == 0) ? 0 : (256 - rem);
+    padded.insert(padded.end(), k, 0);
+    append_u64_be(padded, original_len_bits);
+    assert(padded.size() % 256 == 0);
+
+    // 3) Etat interne 256 bits a 0 (empaquete), puis absorption bloc par bloc
+    const BasicRule &basic = basic_rule(rule);
+    uint64_t packed[4] = {0, 0, 0, 0};
+    for (size_t block = 0; block < padded.size(); block += 256) {
+        for (size_t i = 0; i < 256; ++i)
+            packed[i >> 6] ^= static_cast<uint64_t>(padded[block + i]) << (i & 63);
+        basic_packed_steps(packed, basic, steps);
+    }
+
+    // 4) Finalisation : diffusion supplementaire
+    const size_t FINAL_STEPS = 10;
+    basic_packed_steps(packed, basic, FINAL_STEPS);
+
+    uint8_t state[256];
+    for (size_t i = 0; i < 256; ++i)
+        state[i] = (packed[i >> 6] >> (i & 63)) & 1;
+    return cells_to_digest(state);
+}
+
+string ac_hash_basic(const string &input, uint32_t rule, size_t steps) {
+    return digest_to_hex(ac_hash_basic_digest(input, rule, steps));
+}
+
+// Absorption + finalisation AC_HASH : etat final de 256 cellules
+static void ac_absorb(const string &input, uint32_t rule, size_t steps, uint8_t state[256]) {
+    // 1. Conversion du texte en bits + padding facon SHA
+    vector<uint8_t> input_bits = ac_padded_bits(input);
+
+    // 2. Absorption des blocs avec regle dynamique
+    memset(state, 0, 256);
+    for (size_t block = 0; block < input_bits.size(); block += 256) {
+        for (size_t i = 0; i < 256; ++i)
+            state[i] ^= input_bits[block + i];
+        ac_kernel_steps(state, rule, block, steps);
+    }
+
+    // 3. Finalisation (10 etapes supplementaires)
+    ac_kernel_finalize(state, rule);
+}
+
+Digest256 ac_hash_digest(const string &input, uint32_t rule, size_t steps) {
+    METRIC_ADD(METRIC_HASH_AC, 1);
+    uint8_t state[256];
+    ac_absorb(input, rule, steps, state);
+    return cells_to_digest(state);
+}
+
+string ac_hash(const string &input, uint32_t rule, size_t steps) {
+    return digest_to_hex(ac_hash_digest(input, rule, steps));
+}
+
+// Absorption + finalisation AC-Hash+ : etat final de 512 cellules
+static void plus_absorb(const string &input, uint32_t base_rule, size_t steps, uint8_t state[512]) {
+    // 1-2. Conversion du texte en bits avec permutation, padding avec sel
+    vector<uint8_t> input_bits = plus_padded_bits(input);
+
+    // 3. Etat 512 bits, absorption avec rotation (i * 3) % 512
+    memset(state, 0, 512);
+    for (size_t block = 0; block < input_bits.size(); block += 512) {
+        for (size_t i = 0; i < 512; ++i)
+            state[(i * 3) & 511] ^= input_bits[block + i];
+        plus_kernel_steps(state, base_rule, block, steps);
+    }
+
+    // 4. Finalisation etendue (20 etapes)
+    plus_kernel_finalize(state, base_rule);
+}
+
+#ifdef ACHASH_PACKED_PLUS
+// plus_absorb + compression avec le noyau empaquete
+static Digest256 plus_packed_digest(const string &input, uint32_t base_rule, size_t steps) {
+    vector<uint8_t> input_bits = plus_padded_bits(input);
+
+    uint64_t state[8] = {0};
+    for (size_t block = 0; block < input_bits.size(); block += 512) {
+        for (size_t i = 0; i < 512; ++i) {
+            size_t cell = (i * 3) & 511;
+            state[cell >> 6] ^= static_cast<uint64_t>(input_bits[block + i]) << (cell & 63);
+        }
+        plus_packed_steps(state, base_rule, block, steps);
+    }
+    plus_packed_finalize(state, base_rule);
+
+    Digest256 digest;
+    for (size_t w = 0; w < 4; ++w)
+        digest[w] = reverse_bits64(state[w] ^ state[w + 4]);
+    return digest;
+}
+#endif
+
+bool ac_hash_plus_packed() {
+#ifdef ACHASH_PACKED_PLUS
+    return plus_packed_available();
+#else
+    return false;
+#endif
+}
+
+Digest256 ac_hash_plus_digest(const string &input, uint32_t base_rule, size_t steps) {
+    METRIC_ADD(METRIC_HASH_AC_PLUS, 1);
+#ifdef ACHASH_PACKED_PLUS
+    if (plus_packed_available()) return plus_packed_digest(input, base_rule, steps);
+#endif
+    uint8_t state[512];
+    plus_absorb(input, base_rule, steps, state);
+
+    // 5. Compression 512 -> 256 bits
+    uint8_t final_state[256];
+    for (size_t i = 0; i < 256; ++i)
+        final_state[i] = state[i] ^ state[i + 256];
+
+    return cells_to_digest(final_state);
+}
+
+string ac_hash_plus(const string &input, uint32_t base_rule, size_t steps) {
+    return digest_to_hex(ac_hash_plus_digest(input, base_rule, steps));
+}
+
+// ---------------------- Lots bit-slices (64 messages) ---------------------
+
+void ac_hash_sliced(const string *inputs, size_t count, uint32_t rule, size_t steps, uint64_t sliced[256]) {
+    assert(count >= 1 && count <= ACHASH_LANES);
+    METRIC_ADD(METRIC_HASH_AC, count);
+    const string *group[ACHASH_LANES];
+    for (size_t l = 0; l < count; ++l) {
+        assert(inputs[l].size() == inputs[0].size());
+        group[l] = &inputs[l];
+    }
+    ac_lanes(group, count, rule, steps, sliced);
+}
+
+void ac_hash_plus_sliced(const string *inputs, size_t count, uint32_t base_rule, size_t steps, uint64_t sliced[256]) {
+    assert(count >= 1 && count <= ACHASH_LANES);
+    METRIC_ADD(METRIC_HASH_AC_PLUS, count);
+    const string *group[ACHASH_LANES];
+    for (size_t l = 0; l < count; ++l) {
+        assert(inputs[l].size() == inputs[0].size());
+        group[l] = &inputs[l];
+    }
+    plus_lanes(group, count, base_rule, steps, sliced);
+}
+
+void ac_hash_digest_batch(const string *inputs, size_t count, uint32_t rule, size_t steps, Digest256 *out) {
+    METRIC_ADD(METRIC_HASH_AC, count);
+    batch_by_length(inputs, count, out, [&](const string *const *group, size_t n, uint64_t *sliced) {
+        ac_lanes(group, n, rule, steps, sliced);
+    });
+}
+
+void ac_hash_plus_digest_batch(const string *inputs, size_t count, uint32_t base_rule, size_t steps, Digest256 *out) {
+    METRIC_ADD(METRIC_HASH_AC_PLUS, count);
+    batch_by_length(inputs, count, out, [&](const string *const *group, size_t n, uint64_t *sliced) {
+        plus_lanes(group, n, base_rule, steps, sliced);
+    });
+}
+
+void ac_hash_step_sweep(const string *inputs, size_t count, uint32_t rule,
+                        const size_t *step_counts, size_t num_counts, Digest256 *out) {
+    METRIC_ADD(METRIC_HASH_AC, count * num_counts);
+    sweep_by_length(inputs, count, step_counts, num_counts, AC_SINGLE_BLOCK_BYTES, out,
+        [&](const string *const *group, size_t n, const vector<size_t> &order, uint64_t (*sliced)[256]) {
+            ac_lanes_sweep(group, n, rule, step_counts, order, sliced);
+        },
+        [&](const string &m, size_t steps) { return ac_hash_digest(m, rule, steps); });
+}
+
+void ac_hash_plus_step_sweep(const string *inputs, size_t count, uint32_t base_rule,
+                             const size_t *step_counts, size_t num_counts, Digest256 *out) {
+    METRIC_ADD(METRIC_HASH_AC_PLUS, count * num_counts);
+    sweep_by_length(inputs, count, step_counts, num_counts, PLUS_SINGLE_BLOCK_BYTES, out,
+        [&](const string *const *group, size_t n, const vector<size_t> &order, uint64_t (*sliced)[256]) {
+            plus_lanes_sweep(group, n, base_rule, step_counts, order, sliced);
+        },
+        [&](const string &m, size_t steps) { return ac_hash_plus_digest(m, base_rule, steps); });
+}
+
+// ---------------------------- Mode XOF (eponge) ---------------------------
+//
+// Etat empaquete : cellule i = bit 63 - i % 64 du mot i / 64. Un tour de
+// permutation = une etape d'automate (regle fixe, bord periodique) XOR l'etat
+// tourne de XOF_ROTATIONS[k] cellules, puis injection du compteur de blocs
+// (evite les points fixes comme l'etat nul). Operations sur mots entiers :
+// le compilateur vectorise les boucles de 4 / 8 mots.
+
+static const size_t XOF_ROUNDS = 4;
+static const size_t XOF_ROTATIONS[XOF_ROUNDS] = {97, 29, 173, 61};
+
+// out[cellule i] = ext[cellule (i + r) % (64 * W)], ext = etat recopie deux
+// fois (acces contigus, vectorisables)
+template <size_t W>
+static inline void rotate_cells(const uint64_t *ext, uint64_t *out, size_t r) {
+    size_t q = (r / 64) % W, sh = r % 64;
+    for (size_t w = 0; w < W; ++w)
+        out[w] = sh ? (ext[w + q] << sh) | (ext[w + q + 1] >> (64 - sh)) : ext[w + q];
+}
+
+template <size_t W>
+static inline void xof_permute_words(uint64_t *state, const uint64_t masks[8], uint64_t counter) {
+    uint64_t ext[2 * W + 1], left[W], right[W], mixed[W];
+    for (size_t k = 0; k < XOF_ROUNDS; ++k) {
+        for (size_t w = 0; w < 2 * W + 1; ++w)
+            ext[w] = state[w % W];
+        rotate_cells<W>(ext, left, 64 * W - 1);
+        rotate_cells<W>(ext, right, 1);
+        rotate_cells<W>(ext, mixed, (XOF_ROTATIONS[k] * W / 4) | 1);
+        for (size_t w = 0; w < W; ++w)
+            state[w] = lane_select(masks, left[w], state[w], right[w]) ^ mixed[w];
+        state[0] ^= counter * 0x9e3779b97f4a7c15ULL + k;
+    }
+}
+
+ACHASH_MULTIVERSION
+static void xof_permute_256(uint64_t *state, const uint64_t masks[8], uint64_t counter) {
+    xof_permute_words<4>(state, masks, counter);
+}
+
+ACHASH_MULTIVERSION
+static void xof_permute_512(uint64_t *state, const uint64_t masks[8], uint64_t counter) {
+    xof_permute_words<8>(state, masks, counter);
+}
+
+static void cells_to_words(const uint8_t *cells, size_t count, uint64_t *words) {
+    for (size_t w = 0; w < count / 64; ++w) {
+        uint64_t x = 0;
+        for (size_t b = 0; b < 64; ++b)
+            x = (x << 1) | (cells[64 * w + b] & 1);
+        words[w] = x;
+    }
+}
+
+AcHashXof::AcHashXof(Variant variant, const string &input, uint32_t rule, size_t steps)
+    : plus(variant == AC_HASH_PLUS), blocks(0), available(variant == AC_HASH_PLUS ? 32 : 16) {
+    Digest256 first;
+    if (plus) {
+        METRIC_ADD(METRIC_HASH_AC_PLUS, 1);
+        uint8_t cells[512];
+        plus_absorb(input, rule, steps, cells);
+        cells_to_words(cells, 512, state);
+        for (int w = 0; w < 4; ++w) first[w] = state[w] ^ state[w + 4];
+    } else {
+        METRIC_ADD(METRIC_HASH_AC, 1);
+        uint8_t cells[256];
+        ac_absorb(input, rule, steps, cells);
+        cells_to_words(cells, 256, state);
+        for (int w = 0; w < 4; ++w) first[w] = state[w];
+    }
+    lane_masks(rule % 256, masks);
+    // Bloc 0 : AC-Hash+, l'empreinte habituelle (repliement des deux moities :
+    // 256 bits inconnus restent) ; AC_HASH, le taux seul (128 premiers bits de
+    // l'empreinte), la capacite (mots 2 et 3) n'est jamais sortie
+    for (size_t i = 32 - available; i < 32; ++i) {
+        size_t j = i - (32 - available);
+        buffer[i] = static_cast<uint8_t>(first[j / 8] >> (56 - 8 * (j % 8)));
+    }
+}
+
+// Bloc suivant : permutation puis sortie du taux (rate) de l'etat
+void AcHashXof::refill() {
+    ++blocks;
+    size_t rateWords;
+    if (plus) {
+        xof_permute_512(state, masks, blocks);
+        rateWords = 4;   // 256 bits de taux, 256 bits de capacite
+    } else {
+        xof_permute_256(state, masks, blocks);
+        rateWords = 2;   // 128 bits de taux, 128 bits de capacite
+    }
+    size_t rateBytes = 8 * rateWords;
+    for (size_t i = 0; i < rateBytes; ++i)
+        buffer[32 - rateBytes + i] = static_cast<uint8_t>(state[i / 8] >> (56 - 8 * (i % 8)));
+    available = rateBytes;
+}
+
+void AcHashXof::squeeze(uint8_t *out, size_t length) {
+    while (length > 0) {
+        if (available == 0) {
+            // Blocs complets : directement dans la sortie
+            size_t rateBytes = plus ? 32 : 16;
+            while (length >= rateBytes) {
+                refill();
+                memcpy(out, buffer + 32 - rateBytes, rateBytes);
+                out += rateBytes;
+                length -= rateBytes;
+                available = 0;
+            }
+            if (length == 0) break;
+            refill();
+        }
+        size_t n = min(length, available);
+        memcpy(out, buffer + 32 - available, n);
+        out += n;
+        length -= n;
+        available -= n;
+    }
+}
+
+void ac_hash_xof(const string &input, uint32_t rule, size_t steps, uint8_t *out, size_t length) {
+    AcHashXof(AcHashXof::AC_HASH, input, rule, steps).squeeze(out, length);
+}
+
+void ac_hash_plus_xof(const string &input, uint32_t base_rule, size_t steps, uint8_t *out, size_t length) {
+    AcHashXof(AcHashXof::AC_HASH_PLUS, input, base_rule, steps).squeeze(out, length);
+}
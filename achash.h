@@ -0,0 +1,135 @@
+#ifndef ACHASH_H
+#define ACHASH_H
+
+// ==================== LIBACHASH ====================
+//
+// Bibliotheque commune aux exercices : automate cellulaire 1D (r = 1),
+// AC_HASH (version de base de l'exercice 2 et version a regle dynamique),
+// AC-Hash+ (exercice 10) et SHA-256.
+// Construite en libachash.a / libachash.so par le Makefile ; les noyaux
+// chauds sont compiles en plusieurs versions (x86-64, AVX2, AVX-512) et la
+// meilleure est choisie au chargement selon le CPU (ifunc).
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Multiversion des noyaux (GCC/Clang, cible ELF x86-64). Desactivable avec
+// -DACHASH_NO_MULTIVERSION (ex: MinGW, qui ne supporte pas ifunc).
+#if !defined(ACHASH_NO_MULTIVERSION) && defined(__x86_64__) && defined(__ELF__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define ACHASH_MULTIVERSION __attribute__((target_clones("default", "avx2", "avx512f")))
+#endif
+#endif
+#ifndef ACHASH_MULTIVERSION
+#define ACHASH_MULTIVERSION
+#endif
+
+/**
+ * Empreinte brute de 256 bits : mot k = bits 64k..64k+63, MSB first.
+ * digest_to_hex() donne la meme chaine hexadecimale que les fonctions string.
+ */
+typedef std::array<uint64_t, 4> Digest256;
+
+std::string digest_to_hex(const Digest256 &digest);
+
+// ---------------------- Automate cellulaire (r = 1) --------------------
+
+std::vector<int> init_state(const std::vector<int> &initial_bits);
+std::vector<int> rule_to_binary(int rule_number);
+std::vector<int> evolve(const std::vector<int> &state, int rule_number);
+
+// --------------------------- Fonctions de hachage ----------------------
+
+/**
+ * AC_HASH de base (exercice 2) : regle fixe, 'steps' evolutions par bloc
+ */
+std::string ac_hash_basic(const std::string &input, uint32_t rule, size_t steps);
+Digest256 ac_hash_basic_digest(const std::string &input, uint32_t rule, size_t steps);
+
+/**
+ * AC_HASH a regle dynamique et melange additionnel (exercices 3 a 7)
+ */
+std::string ac_hash(const std::string &input, uint32_t rule, size_t steps);
+Digest256 ac_hash_digest(const std::string &input, uint32_t rule, size_t steps);
+
+/**
+ * AC-Hash+ : etat 512 bits, voisinage variable, compression 512 -> 256 (exercice 10).
+ * Etat empaquete dans 8 mots de 64 bits si le CPU a AVX2 et un pext rapide
+ * (meme resultat) ; ac_hash_plus_packed() indique le noyau retenu.
+ */
+std::string ac_hash_plus(const std::string &input, uint32_t base_rule, size_t steps);
+Digest256 ac_hash_plus_digest(const std::string &input, uint32_t base_rule, size_t steps);
+bool ac_hash_plus_packed();
+
+// ---------------------- Lots bit-slices (64 messages) ---------------------
+
+/**
+ * Hachage par lots : jusqu'a ACHASH_LANES messages traites ensemble, la
+ * cellule i de tous les etats tenant dans un mot (bit l = message l).
+ * Les messages de longueurs differentes sont regroupes par longueur.
+ * Resultat identique a ac_hash_digest / ac_hash_plus_digest message par message.
+ */
+const size_t ACHASH_LANES = 64;
+
+void ac_hash_digest_batch(const std::string *inputs, size_t count, uint32_t rule, size_t steps, Digest256 *out);
+void ac_hash_plus_digest_batch(const std::string *inputs, size_t count, uint32_t base_rule, size_t steps, Digest256 *out);
+
+/**
+ * Variante sans transposition : sliced[j] = bit j (ordre hexadecimal) des
+ * empreintes, bit l pour le message l. Tous les messages doivent avoir la
+ * meme longueur et count <= ACHASH_LANES.
+ */
+void ac_hash_sliced(const std::string *inputs, size_t count, uint32_t rule, size_t steps, uint64_t sliced[256]);
+void ac_hash_plus_sliced(const std::string *inputs, size_t count, uint32_t base_rule, size_t steps, uint64_t sliced[256]);
+
+/**
+ * Balayage du nombre d'etapes : out[k * count + i] = empreinte du message i
+ * avec step_counts[k] etapes (ordre quelconque). Pour un message d'un seul
+ * bloc (AC_HASH <= 23 octets, AC-Hash+ <= 51 octets), une seule evolution
+ * par lot de 64 sert tous les nombres d'etapes ; au-dela, calcul classique.
+ */
+void ac_hash_step_sweep(const std::string *inputs, size_t count, uint32_t rule,
+                        const size_t *step_counts, size_t num_counts, Digest256 *out);
+void ac_hash_plus_step_sweep(const std::string *inputs, size_t count, uint32_t base_rule,
+                             const size_t *step_counts, size_t num_counts, Digest256 *out);
+
+// --------------------------- Mode XOF (eponge) ---------------------------
+
+/**
+ * Sortie de longueur arbitraire : apres absorption et finalisation, l'etat
+ * complet est conserve (256 ou 512 bits) et permute a chaque bloc ; squeeze()
+ * peut etre appele plusieurs fois et continue le flux. Seul le taux sort :
+ * 16 octets par bloc pour AC_HASH (capacite de 128 bits jamais sortie ; le
+ * bloc 0 est la premiere moitie de ac_hash_digest), 32 pour AC-Hash+ (le
+ * bloc 0 est ac_hash_plus_digest, repliement qui laisse 256 bits inconnus).
+ */
+class AcHashXof {
+public:
+    enum Variant { AC_HASH, AC_HASH_PLUS };
+
+    AcHashXof(Variant variant, const std::string &input, uint32_t rule, size_t steps);
+    void squeeze(uint8_t *out, size_t length);
+
+private:
+    void refill();
+
+    bool plus;
+    uint64_t state[8];
+    uint64_t masks[8];
+    uint64_t blocks;
+    uint8_t buffer[32];
+    size_t available;   // octets restants a la fin de buffer
+};
+
+void ac_hash_xof(const std::string &input, uint32_t rule, size_t steps, uint8_t *out, size_t length);
+void ac_hash_plus_xof(const std::string &input, uint32_t base_rule, size_t steps, uint8_t *out, size_t length);
+
+/**
+ * SHA-256 (sha256.cpp)
+ */
+std::string sha256(const std::string &data);
+
+#endif
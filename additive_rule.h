@@ -0,0 +1,165 @@
+#ifndef ADDITIVE_RULE_H
+#define ADDITIVE_RULE_H
+
+// ==================== REGLES ADDITIVES : SAUT EN O(n log t) ====================
+//
+// Une regle additive (lineaire sur GF(2)) calcule le XOR d'un sous-ensemble
+// fixe de son voisinage : 90 = g ^ d, 150 = g ^ c ^ d, 60 = g ^ c, 102 = c ^ d.
+// Son operateur s'ecrit L = somme des decalages S^o (o : offsets retenus) et,
+// les decalages commutant sur l'anneau, le carre sur GF(2) donne
+//     L^(2^k) = somme des S^(o 2^k)        (les termes croises s'annulent)
+// d'ou x_t = produit, sur les bits k de t, des L^(2^k) appliques a x : au plus
+// (2r + 1) decalages-XOR de l'etat empaquete par bit de t, soit O(n log t) au
+// lieu de O(n t) pour evolve().
+//
+// Les regles affines (complement d'une regle additive, ex. 105 = ~150)
+// ajoutent le vecteur de 1, vecteur propre de L sur l'anneau : terme constant.
+//
+// Bords fixes : les decalages a remplissage par 0 ne commutent que s'ils vont
+// tous dans le meme sens (60, 102, 170, 240...). Pour une regle symetrique de
+// rayon 1 (90, 150), l'etat est plonge dans un anneau de 2 (n + 1) cellules
+// (miroir autour de deux cellules nulles, qui le restent). Les autres cas
+// (regle affine ou non symetrique a bords fixes) ne sont pas pris en charge :
+// supports() renvoie false.
+
+#include "cellular_automaton.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// acc[i] ^= cellule (i + s) de y, 0 hors de [0, 64 W) ; y a ses bits au-dela
+// de n a 0, les bits de acc au-dela de n sont a remasquer par l'appelant
+inline void xor_shifted(uint64_t *acc, const uint64_t *y, size_t W, long long s) {
+    long long q = s >= 0 ? s / 64 : -((-s + 63) / 64);
+    int r = static_cast<int>(s - 64 * q);
+    long long words = static_cast<long long>(W);
+    auto word = [&](long long j) { return (j >= 0 && j < words) ? y[j] : 0ULL; };
+    long long first = std::max(0LL, -q - 1), last = std::min(words, words - q);
+    for (long long i = first; i < last; ++i)
+        acc[i] ^= r ? (word(i + q) >> r) | (word(i + q + 1) << (64 - r)) : word(i + q);
+}
+
+template <int Radius>
+class AdditiveRule {
+private:
+    static constexpr int window = 2 * Radius + 1;
+
+    uint32_t mask_ = 0;        // bit b du motif (offset Radius - b) present dans le XOR
+    bool complement_ = false;  // regle affine : sortie complementee
+    bool valid_ = false;
+
+    bool one_sided() const {
+        uint32_t left = mask_ >> (Radius + 1), right = mask_ & ((1u << Radius) - 1);
+        return left == 0 || right == 0;
+    }
+
+    bool symmetric() const {
+        for (int b = 0; b < window; ++b)
+            if (((mask_ >> b) & 1) != ((mask_ >> (window - 1 - b)) & 1)) return false;
+        return true;
+    }
+
+    // Un facteur L^(2^k) ; 'step' = 2^k reduit modulo n (anneau) ou sature a n (bords fixes)
+    void apply_power(PackedRing &y, uint64_t step, bool periodic) const {
+        const size_t W = y.words.size();
+        const long long n = static_cast<long long>(y.cells);
+        PackedRing acc(y.cells);
+        for (int b = 0; b < window; ++b) {
+            if (((mask_ >> b) & 1) == 0) continue;
+            long long offset = Radius - b;
+            if (offset == 0) {
+                for (size_t w = 0; w < W; ++w) acc.words[w] ^= y.words[w];
+            } else if (periodic) {
+                // y[(i + s) mod n] : decalage de s, puis de s - n pour la partie repliee
+                long long s = static_cast<long long>((static_cast<uint64_t>(offset > 0 ? offset : -offset) * step) % n);
+                if (offset < 0) s = (n - s) % n;
+                if (s == 0) {
+                    for (size_t w = 0; w < W; ++w) acc.words[w] ^= y.words[w];
+                    continue;
+                }
+                xor_shifted(acc.words.data(), y.words.data(), W, s);
+                xor_shifted(acc.words.data(), y.words.data(), W, s - n);
+            } else if (static_cast<unsigned __int128>(offset < 0 ? -offset : offset) * step < static_cast<uint64_t>(n)) {
+                xor_shifted(acc.words.data(), y.words.data(), W, offset * static_cast<long long>(step));
+            }
+        }
+        if (W) acc.words[W - 1] &= acc.last_mask();
+        y = std::move(acc);
+    }
+
+    PackedRing jump_shifts(const PackedRing &x, uint64_t t, bool periodic) const {
+        PackedRing y = x;
+        if (y.cells == 0) return y;
+        const uint64_t n = y.cells;
+        // 2^k reduit modulo n (anneau) ou sature a n (au-dela, tout decalage sort)
+        uint64_t step = periodic ? 1 % n : 1;
+        for (uint64_t rest = t; rest != 0; rest >>= 1) {
+            if (rest & 1) apply_power(y, step, periodic);
+            step = periodic ? (2 * step) % n : std::min<uint64_t>(2 * step, n);
+        }
+        if (complement_ && t != 0) {
+            // somme des L^i 1, i < t : L 1 = parite(masque) 1
+            bool ones = (__builtin_popcount(mask_) & 1) ? (t & 1) : true;
+            if (ones) {
+                for (uint64_t &w : y.words) w = ~w;
+                y.words.back() &= y.last_mask();
+            }
+        }
+        return y;
+    }
+
+public:
+    AdditiveRule() = default;
+
+    // Invalide si la regle n'est pas lineaire (ou affine) sur GF(2)
+    static AdditiveRule detect(const CellularAutomaton<Radius> &ca) {
+        AdditiveRule rule;
+        rule.complement_ = ca.output(0);
+        for (int b = 0; b < window; ++b)
+            if (ca.output(1u << b) != rule.complement_) rule.mask_ |= 1u << b;
+        for (uint32_t p = 0; p < (1u << window); ++p)
+            if (ca.output(p) != (rule.complement_ ^ (__builtin_popcount(p & rule.mask_) & 1))) return AdditiveRule();
+        rule.valid_ = true;
+        return rule;
+    }
+
+    // Reconnaissance a partir du numero de regle (ex. 90, 150, 60, 102)
+    static AdditiveRule from_number(uint64_t rule) {
+        return detect(CellularAutomaton<Radius>::from_number(rule));
+    }
+
+    bool valid() const { return valid_; }
+    bool complement() const { return complement_; }
+    uint32_t mask() const { return mask_; }
+
+    bool supports(Boundary boundary) const {
+        if (!valid_) return false;
+        if (boundary == Boundary::PERIODIC) return true;
+        return !complement_ && (one_sided() || (Radius == 1 && symmetric()));
+    }
+
+    /**
+     * Etat apres t generations, en O(n log t). Suppose supports(boundary).
+     */
+    PackedRing jump(const PackedRing &x, uint64_t t, Boundary boundary = Boundary::PERIODIC) const {
+        if (boundary == Boundary::PERIODIC || one_sided()) return jump_shifts(x, t, boundary == Boundary::PERIODIC);
+
+        // Rayon 1 symetrique a bords fixes : anneau miroir 0 x0 .. x(n-1) 0 x(n-1) .. x0
+        const size_t n = x.cells;
+        PackedRing mirror(2 * (n + 1));
+        for (size_t i = 0; i < n; ++i) {
+            if (!x.get(i)) continue;
+            mirror.set(1 + i, true);
+            mirror.set(2 * (n + 1) - 1 - i, true);
+        }
+        mirror = jump_shifts(mirror, t, true);
+        PackedRing out(n);
+        for (size_t i = 0; i < n; ++i)
+            if (mirror.get(1 + i)) out.set(i, true);
+        return out;
+    }
+};
+
+#endif
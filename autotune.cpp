@@ -0,0 +1,366 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include "achash.h"
+#include "corpus.h"
+#include "digest_stats.h"
+#include "hash_config.h"
+#include "sequential.h"
+#include "trace.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// ==================== AUTOTUNEUR (VARIANTE x REGLE x ETAPES) ====================
+//
+// Chaque point (variante, regle, etapes) est mesure sur les memes messages :
+//   - avalanche : % de bits changes apres inversion d'un bit d'entree,
+//   - equilibre : % de 1 par empreinte, et biais par position (chi-carre),
+//   - cout : ns par hash du noyau scalaire (celui qu'utilise compute_hash) ;
+//     la regle n'est qu'une table, le cout ne depend donc que de (variante,
+//     etapes) et n'est mesure qu'une fois par couple.
+// Tours : tous les points sur STAGE_SAMPLES messages, puis les survivants
+// sur 4 fois plus a chaque tour jusqu'a l'echantillon complet. Apres chaque
+// tour, un point dont le defaut (|avalanche - 50| + |equilibre - 50|), moins
+// sa marge statistique, depasse celui d'un point moins couteux (plus sa
+// marge) qui respecte le seuil de qualite est elague : un point bon marche
+// mais hors seuil (ex. biais par position) n'elimine personne. Le front de
+// Pareto (cout, defaut) est affiche, et le point le moins couteux qui
+// respecte le seuil de qualite est ecrit dans le fichier de configuration.
+
+const size_t STAGE_SAMPLES = 64;
+const size_t STAGE_GROWTH = 4;
+const size_t TIMING_HASHES = 256;
+const int TIMING_REPEATS = 3;
+const double POSITION_P_MIN = 0.001;   // p-value minimale du biais par position
+
+struct TuneConfig {
+    vector<uint32_t> rules;          // vide : les 256 regles
+    vector<size_t> steps = {1, 2, 3, 5, 10};
+    vector<string> variants = {"ac", "plus"};
+    size_t samples = 1024;
+    size_t length = 64;              // octets par message
+    double tolerance = 1.0;          // ecart max a 50 % (avalanche et equilibre)
+    unsigned threads = 0;            // 0 : tous les coeurs
+    string output = hash_config_path();
+    string prefix = "autotune";
+};
+
+struct TunePoint {
+    HashConfig hash;
+    RunningStats avalanche;          // % de bits changes, par paire
+    RunningStats balance;            // % de 1, par empreinte
+    BitPositionCounter positions;
+    double nsPerHash = 0;
+    bool pruned = false;
+    bool front = false;
+
+    double defect() const { return fabs(avalanche.mean() - 50.0) + fabs(balance.mean() - 50.0); }
+    double margin() const { return 2.0 * (avalanche.standardError() + balance.standardError()); }
+
+    // p-value du chi-carre (256 ddl) des comptes de 1 par position
+    double positionPValue() {
+        uint64_t n = positions.count();
+        if (n == 0) return 1.0;
+        const uint64_t *ones = positions.ones();
+        double chi2 = 0, expected = n / 2.0;
+        for (int j = 0; j < DIGEST_BITS; j++) chi2 += 2 * (ones[j] - expected) * (ones[j] - expected) / expected;
+        return chi2_pvalue(chi2, DIGEST_BITS);
+    }
+
+    string name() const {
+        return string(hash.plus ? "plus" : "ac") + "/" + to_string(hash.rule) + "/" + to_string(hash.steps);
+    }
+};
+
+// Seuil de qualite : avalanche et equilibre a 'tolerance' % de 50, pas de biais par position
+static bool passes(TunePoint &p, double tolerance) {
+    return fabs(p.avalanche.mean() - 50.0) <= tolerance && fabs(p.balance.mean() - 50.0) <= tolerance &&
+           p.positionPValue() >= POSITION_P_MIN;
+}
+
+struct TuneCorpus {
+    vector<string> originals;
+    vector<string> modified;         // original avec un bit inverse
+};
+
+static TuneCorpus make_corpus(const TuneConfig &cfg) {
+    MessageCorpus corpus(corpus_kind_from_env(), cfg.length, corpus_seed_from_env());
+    corpus.fill(0, cfg.samples);
+    TuneCorpus c;
+    for (size_t i = 0; i < corpus.size(); i++) {
+        c.originals.emplace_back(corpus[i]);
+        c.modified.push_back(c.originals.back());
+        flip_random_bit(c.modified.back(), corpus.rng());
+    }
+    return c;
+}
+
+// Messages [from, to) : qualite par lots de 64 (noyaux bit-slices)
+static void measure_quality(TunePoint &p, const TuneCorpus &c, size_t from, size_t to) {
+    TRACE_SCOPE_ARG("measure_quality", "rule", p.hash.rule);
+    Digest256 h0[ACHASH_LANES], h1[ACHASH_LANES];
+    for (size_t first = from; first < to; first += ACHASH_LANES) {
+        size_t count = min(ACHASH_LANES, to - first);
+        if (p.hash.plus) {
+            ac_hash_plus_digest_batch(&c.originals[first], count, p.hash.rule, p.hash.steps, h0);
+            ac_hash_plus_digest_batch(&c.modified[first], count, p.hash.rule, p.hash.steps, h1);
+        } else {
+            ac_hash_digest_batch(&c.originals[first], count, p.hash.rule, p.hash.steps, h0);
+            ac_hash_digest_batch(&c.modified[first], count, p.hash.rule, p.hash.steps, h1);
+        }
+        for (size_t i = 0; i < count; i++) {
+            p.avalanche.add(digest_hamming(h0[i], h1[i]) * 100.0 / DIGEST_BITS);
+            p.balance.add(digest_ones(h0[i]) * 100.0 / DIGEST_BITS);
+            p.positions.add(h0[i]);
+        }
+    }
+}
+
+// Cout du noyau scalaire (meilleur de quelques repetitions)
+static double measure_cost(const HashConfig &h, const TuneCorpus &c) {
+    size_t n = min(TIMING_HASHES, c.originals.size());
+    double best = 1e300;
+    volatile uint64_t sink = 0;
+    for (int r = 0; r < TIMING_REPEATS; r++) {
+        auto start = steady_clock::now();
+        for (size_t i = 0; i < n; i++) {
+            Digest256 d = h.plus ? ac_hash_plus_digest(c.originals[i], h.rule, h.steps)
+                                 : ac_hash_digest(c.originals[i], h.rule, h.steps);
+            sink = sink ^ d[0];
+        }
+        best = min(best, duration<double>(steady_clock::now() - start).count());
+    }
+    return best * 1e9 / n;
+}
+
+// Distribue les index [0, count) aux threads (compteur atomique partage)
+static void parallel_for(size_t count, unsigned threads, const function<void(size_t)> &fn) {
+    atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i; (i = next.fetch_add(1, memory_order_relaxed)) < count;) fn(i);
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (thread &th : pool) th.join();
+}
+
+// Elagage : points tries par cout croissant, meilleur majorant du defaut deja
+// vu parmi les points au seuil (seuls candidats possibles a la selection)
+static size_t prune_dominated(vector<TunePoint> &points, const vector<size_t> &byCost, double tolerance) {
+    double bestUpper = 1e300;
+    size_t pruned = 0;
+    for (size_t k : byCost) {
+        TunePoint &p = points[k];
+        if (p.pruned) continue;
+        if (p.defect() - p.margin() > bestUpper) {
+            p.pruned = true;
+            pruned++;
+        } else if (passes(p, tolerance)) {
+            bestUpper = min(bestUpper, p.defect() + p.margin());
+        }
+    }
+    return pruned;
+}
+
+template <typename T>
+static vector<T> parse_list(const string &s) {
+    vector<T> out;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty()) out.push_back(static_cast<T>(stoul(item)));
+    return out;
+}
+
+static vector<string> parse_names(const string &s) {
+    vector<string> out;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty()) out.push_back(item);
+    return out;
+}
+
+static void write_csv(const string &path, vector<TunePoint> &points) {
+    ofstream out(path);
+    out << "variante,regle,etapes,echantillons,avalanche,equilibre,defaut,marge,p_positions,ns_hash,elague,pareto\n";
+    out << fixed << setprecision(4);
+    for (TunePoint &p : points) {
+        out << (p.hash.plus ? "plus" : "ac") << ',' << p.hash.rule << ',' << p.hash.steps << ','
+            << p.avalanche.count() << ',' << p.avalanche.mean() << ',' << p.balance.mean() << ','
+            << p.defect() << ',' << p.margin() << ',' << p.positionPValue() << ',' << p.nsPerHash << ','
+            << (p.pruned ? 1 : 0) << ',' << (p.front ? 1 : 0) << '\n';
+    }
+}
+
+// Usage : autotune [regles ex: 30,90,110|all] [etapes ex: 1,2,3,5,10] [variantes ex: ac,plus]
+//                  [echantillons] [tolerance %] [threads] [fichier config] [prefixe csv]
+int main(int argc, char **argv) {
+    TuneConfig cfg;
+    if (argc > 1 && string(argv[1]) != "all") cfg.rules = parse_list<uint32_t>(argv[1]);
+    if (argc > 2) cfg.steps = parse_list<size_t>(argv[2]);
+    if (argc > 3) cfg.variants = parse_names(argv[3]);
+    if (argc > 4) cfg.samples = stoul(argv[4]);
+    if (argc > 5) cfg.tolerance = stod(argv[5]);
+    if (argc > 6) cfg.threads = static_cast<unsigned>(stoul(argv[6]));
+    if (argc > 7) cfg.output = argv[7];
+    if (argc > 8) cfg.prefix = argv[8];
+    if (cfg.rules.empty())
+        for (uint32_t r = 0; r < 256; r++) cfg.rules.push_back(r);
+
+    bool validVariants = !cfg.variants.empty();
+    for (const string &v : cfg.variants) validVariants = validVariants && (v == "ac" || v == "plus");
+    if (!validVariants || cfg.steps.empty() || cfg.samples < STAGE_SAMPLES) {
+        cerr << "Usage: autotune [regles|all] [etapes] [variantes ac,plus] [echantillons>=" << STAGE_SAMPLES
+             << "] [tolerance %] [threads] [fichier config] [prefixe csv]" << endl;
+        return 1;
+    }
+    unsigned threads = cfg.threads ? cfg.threads : thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+
+    vector<TunePoint> points;
+    for (const string &v : cfg.variants)
+        for (uint32_t rule : cfg.rules)
+            for (size_t steps : cfg.steps) {
+                points.emplace_back();
+                points.back().hash.plus = (v == "plus");
+                points.back().hash.rule = rule;
+                points.back().hash.steps = steps;
+            }
+
+    cout << "==============================================" << endl;
+    cout << "AUTOTUNEUR AC_HASH (qualite / cout)" << endl;
+    cout << "==============================================" << endl;
+    cout << "Points: " << points.size() << ", Messages: " << cfg.samples << " x " << cfg.length
+         << " octets (corpus " << corpus_kind_name(corpus_kind_from_env()) << "), Threads: " << threads << endl;
+    cout << "Seuil: |avalanche - 50| et |equilibre - 50| <= " << cfg.tolerance
+         << " %, biais par position p >= " << POSITION_P_MIN << endl << endl;
+
+    auto start = steady_clock::now();
+    TuneCorpus corpus = make_corpus(cfg);
+
+    // ---- Cout par (variante, etapes), mesure sans concurrence ----
+    {
+        TRACE_SCOPE("cost");
+        for (const string &v : cfg.variants)
+            for (size_t steps : cfg.steps) {
+                HashConfig h;
+                h.plus = (v == "plus");
+                h.steps = steps;
+                double ns = measure_cost(h, corpus);
+                for (TunePoint &p : points)
+                    if (p.hash.plus == h.plus && p.hash.steps == steps) p.nsPerHash = ns;
+            }
+    }
+
+    // ---- Tour 1 : tous les points, peu d'echantillons ----
+    {
+        TRACE_SCOPE_ARG("stage", "points", points.size());
+        parallel_for(points.size(), threads, [&](size_t k) {
+            measure_quality(points[k], corpus, 0, STAGE_SAMPLES);
+        });
+    }
+    // Cout croissant ; a cout egal, meilleur defaut d'abord
+    vector<size_t> byCost(points.size());
+    for (size_t k = 0; k < points.size(); k++) byCost[k] = k;
+    auto cheaper = [&](size_t a, size_t b) {
+        if (points[a].nsPerHash != points[b].nsPerHash) return points[a].nsPerHash < points[b].nsPerHash;
+        return points[a].defect() < points[b].defect();
+    };
+
+    // ---- Tours suivants : survivants seulement ----
+    vector<size_t> survivors;
+    for (size_t done = STAGE_SAMPLES;;) {
+        sort(byCost.begin(), byCost.end(), cheaper);
+        size_t pruned = prune_dominated(points, byCost, cfg.tolerance);
+        survivors.clear();
+        for (size_t k : byCost) if (!points[k].pruned) survivors.push_back(k);
+        cout << "Tour a " << setw(6) << done << " messages: " << setw(5) << pruned << " points domines elagues, "
+             << survivors.size() << " restants" << endl;
+        if (done >= cfg.samples) break;
+
+        size_t next = min(done * STAGE_GROWTH, cfg.samples);
+        TRACE_SCOPE_ARG("stage", "points", survivors.size());
+        parallel_for(survivors.size(), threads, [&](size_t i) {
+            measure_quality(points[survivors[i]], corpus, done, next);
+        });
+        done = next;
+    }
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    // ---- Front de Pareto (cout croissant, defaut strictement decroissant) ----
+    double bestDefect = 1e300;
+    for (size_t k : survivors) {
+        if (points[k].defect() < bestDefect) {
+            bestDefect = points[k].defect();
+            points[k].front = true;
+        }
+    }
+
+    cout << "\nFRONT DE PARETO (qualite / cout)" << endl;
+    cout << left << setw(18) << "Point" << right << setw(12) << "Avalanche%" << setw(12) << "Equilibre%"
+         << setw(10) << "Defaut" << setw(10) << "p_pos" << setw(12) << "ns/hash" << setw(8) << "Seuil" << endl;
+    cout << string(82, '-') << endl;
+
+    TunePoint *chosen = nullptr;
+    for (size_t k : survivors) {
+        TunePoint &p = points[k];
+        if (passes(p, cfg.tolerance) && !chosen) chosen = &p;
+        if (!p.front) continue;
+        cout << left << setw(18) << p.name() << right << fixed << setprecision(2)
+             << setw(12) << p.avalanche.mean() << setw(12) << p.balance.mean() << setw(10) << p.defect()
+             << setw(10) << setprecision(4) << p.positionPValue() << setw(12) << setprecision(1) << p.nsPerHash
+             << setw(8) << (passes(p, cfg.tolerance) ? "oui" : "non") << endl;
+    }
+
+    // Resume par couple (variante, etapes) : meme cout pour toutes les regles
+    cout << "\nPAR (VARIANTE, ETAPES)" << endl;
+    cout << left << setw(10) << "Variante" << right << setw(8) << "Etapes" << setw(12) << "ns/hash"
+         << setw(12) << "Evaluees" << setw(12) << "Au seuil" << setw(18) << "Meilleure regle" << endl;
+    for (const string &v : cfg.variants)
+        for (size_t steps : cfg.steps) {
+            size_t evaluated = 0, passing = 0;
+            TunePoint *best = nullptr;
+            double ns = 0;
+            for (size_t k : survivors) {
+                TunePoint &p = points[k];
+                if (p.hash.plus != (v == "plus") || p.hash.steps != steps) continue;
+                ns = p.nsPerHash;
+                evaluated++;
+                if (passes(p, cfg.tolerance)) passing++;
+                if (!best || p.defect() < best->defect()) best = &p;
+            }
+            cout << left << setw(10) << v << right << setw(8) << steps << setw(12) << setprecision(1) << ns
+                 << setw(12) << evaluated << setw(12) << passing << setw(18) << (best ? to_string(best->hash.rule) : "-") << endl;
+        }
+
+    write_csv(cfg.prefix + ".csv", points);
+    cout << "\nTous les points: " << cfg.prefix << ".csv (" << seconds * 1000 << " ms)" << endl;
+
+    if (!chosen) {
+        cout << "Aucun point ne respecte le seuil : configuration non modifiee" << endl;
+        return 2;
+    }
+    stringstream comment;
+    comment << fixed << setprecision(2) << "autotune: avalanche " << chosen->avalanche.mean() << " %, equilibre "
+            << chosen->balance.mean() << " %, " << setprecision(1) << chosen->nsPerHash << " ns/hash, "
+            << chosen->avalanche.count() << " messages de " << cfg.length << " octets";
+    if (!save_hash_config(chosen->hash, comment.str(), cfg.output)) {
+        cerr << "Impossible d'ecrire " << cfg.output << endl;
+        return 1;
+    }
+    cout << "Configuration choisie (la moins couteuse au-dessus du seuil): " << chosen->name()
+         << " -> " << cfg.output << endl;
+    return 0;
+}
@@ -0,0 +1,196 @@
+#ifndef AVALANCHE_H
+#define AVALANCHE_H
+
+// ==================== MOTEUR D'EFFET AVALANCHE ====================
+//
+// Pour chaque message original : un seul hash de l'original, puis un hash par
+// bit d'entree inverse (8 x longueur paires). La distance de Hamming entre les
+// empreintes brutes (Digest256) est comptee par popcount dans un histogramme
+// 0..256 local a chaque thread, fusionne a la fin.
+// Les messages sont tires d'un generateur a compteur (graine, index) : le
+// message i est le meme quel que soit le nombre de threads, donc le resultat
+// est reproductible a l'identique.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "achash.h"
+#include "digest_stats.h"
+#include "trace.h"
+
+const int AVALANCHE_BINS = 257; // distances 0..256
+
+/**
+ * Generateur a compteur (SplitMix64) : valeur = f(graine, flux, compteur),
+ * sans etat partage entre threads.
+ */
+struct CounterRng {
+    uint64_t key;
+
+    CounterRng(uint64_t seed, uint64_t stream) : key(mix(seed ^ mix(stream + 0x9e3779b97f4a7c15ULL))) {}
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t at(uint64_t counter) const {
+        return mix(key + (counter + 1) * 0x9e3779b97f4a7c15ULL);
+    }
+};
+
+struct AvalancheConfig {
+    size_t messages = 200;       // nombre de messages originaux
+    size_t messageLength = 16;   // octets par message
+    unsigned threads = 0;        // 0 : std::thread::hardware_concurrency()
+    uint64_t seed = 2024;
+};
+
+struct AvalancheResult {
+    uint64_t histogram[AVALANCHE_BINS] = {};
+    uint64_t pairs = 0;
+    uint64_t hashes = 0;
+    unsigned threads = 0;
+
+    double mean() const {
+        double sum = 0;
+        for (int d = 0; d < AVALANCHE_BINS; d++) sum += (double)d * histogram[d];
+        return pairs ? sum / pairs : 0.0;
+    }
+
+    double stddev() const {
+        if (pairs < 2) return 0.0;
+        double m = mean(), sq = 0;
+        for (int d = 0; d < AVALANCHE_BINS; d++) sq += (d - m) * (d - m) * histogram[d];
+        return std::sqrt(sq / (pairs - 1));
+    }
+
+    int minDistance() const {
+        for (int d = 0; d < AVALANCHE_BINS; d++) if (histogram[d]) return d;
+        return 0;
+    }
+
+    int maxDistance() const {
+        for (int d = AVALANCHE_BINS - 1; d >= 0; d--) if (histogram[d]) return d;
+        return 0;
+    }
+};
+
+// Message 'index' : octets tires du flux 'index' du generateur a compteur
+inline void avalanche_message(const AvalancheConfig &cfg, uint64_t index, std::string &out) {
+    CounterRng rng(cfg.seed, index);
+    out.resize(cfg.messageLength);
+    for (size_t k = 0; k < cfg.messageLength; k += 8) {
+        uint64_t r = rng.at(k / 8);
+        for (size_t b = k; b < cfg.messageLength && b < k + 8; b++, r >>= 8)
+            out[b] = static_cast<char>(r & 0xff);
+    }
+}
+
+/**
+ * Lance le test sur cfg.threads threads. Les messages sont distribues par
+ * paquets via un compteur atomique ; l'ordre de traitement n'influe pas sur
+ * l'histogramme (somme commutative).
+ */
+template <typename HashFn>
+AvalancheResult run_avalanche(const AvalancheConfig &cfg, HashFn hash_digest) {
+    unsigned threads = cfg.threads ? cfg.threads : std::thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    const size_t CHUNK = 4;
+
+    std::atomic<size_t> next{0};
+    std::vector<AvalancheResult> partial(threads);
+
+    auto worker = [&](unsigned t) {
+        TRACE_SCOPE_ARG("avalanche_worker", "thread", t);
+        AvalancheResult &local = partial[t];
+        std::string original, modified;
+        for (;;) {
+            size_t first = next.fetch_add(CHUNK, std::memory_order_relaxed);
+            if (first >= cfg.messages) break;
+            size_t last = std::min(first + CHUNK, cfg.messages);
+            for (size_t i = first; i < last; i++) {
+                avalanche_message(cfg, i, original);
+                Digest256 h0 = hash_digest(original);
+                local.hashes++;
+                modified = original;
+                for (size_t bit = 0; bit < 8 * cfg.messageLength; bit++) {
+                    char &c = modified[bit / 8];
+                    c ^= static_cast<char>(1 << (bit % 8));
+                    local.histogram[digest_hamming(h0, hash_digest(modified))]++;
+                    c ^= static_cast<char>(1 << (bit % 8));
+                }
+                local.hashes += 8 * cfg.messageLength;
+                local.pairs += 8 * cfg.messageLength;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker, t);
+    worker(0);
+    for (std::thread &th : pool) th.join();
+
+    AvalancheResult total;
+    total.threads = threads;
+    for (const AvalancheResult &p : partial) {
+        for (int d = 0; d < AVALANCHE_BINS; d++) total.histogram[d] += p.histogram[d];
+        total.pairs += p.pairs;
+        total.hashes += p.hashes;
+    }
+    return total;
+}
+
+// ---------------------------- Ajustement a Binomial(256, 1/2) ----------------------------
+
+struct GoodnessOfFit {
+    double chiSquared = 0;
+    int degreesOfFreedom = 0;
+    double pValue = 1.0;
+};
+
+// P(D = d) pour D ~ Binomial(256, 1/2)
+inline double binomial_half_pmf(int n, int d) {
+    return std::exp(std::lgamma(n + 1.0) - std::lgamma(d + 1.0) - std::lgamma(n - d + 1.0) - n * std::log(2.0));
+}
+
+/**
+ * Chi-carre de l'histogramme contre Binomial(256, 1/2). Les queues sont
+ * regroupees jusqu'a un effectif attendu >= 5 par classe.
+ */
+inline GoodnessOfFit avalanche_goodness_of_fit(const AvalancheResult &r) {
+    GoodnessOfFit fit;
+    if (r.pairs == 0) return fit;
+
+    const double MIN_EXPECTED = 5.0;
+    std::vector<double> expected, observed;
+    double e = 0, o = 0;
+    for (int d = 0; d < AVALANCHE_BINS; d++) {
+        e += r.pairs * binomial_half_pmf(256, d);
+        o += r.histogram[d];
+        if (e >= MIN_EXPECTED) {
+            expected.push_back(e);
+            observed.push_back(o);
+            e = o = 0;
+        }
+    }
+    // Reste de la queue droite : fusionne avec la derniere classe
+    if (!expected.empty()) {
+        expected.back() += e;
+        observed.back() += o;
+    }
+    if (expected.size() < 2) return fit;
+
+    for (size_t k = 0; k < expected.size(); k++)
+        fit.chiSquared += (observed[k] - expected[k]) * (observed[k] - expected[k]) / expected[k];
+    fit.degreesOfFreedom = static_cast<int>(expected.size()) - 1;
+    fit.pValue = chi2_pvalue(fit.chiSquared, fit.degreesOfFreedom);
+    return fit;
+}
+
+#endif
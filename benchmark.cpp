@@ -0,0 +1,140 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <functional>
+#include "achash.h"
+#include "perf_counters.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// ==================== BENCHMARK DES NOYAUX DE LIBACHASH ====================
+
+struct BenchResult {
+    string name;
+    size_t hashes;
+    double ns_per_hash;
+    double mb_per_s;
+};
+
+// Messages de test reproductibles (graine fixe)
+vector<string> make_messages(size_t count, size_t length) {
+    mt19937 gen(12345);
+    uniform_int_distribution<> dis(32, 126);
+    vector<string> messages(count, string(length, ' '));
+    for (string &m : messages)
+        for (char &c : m) c = static_cast<char>(dis(gen));
+    return messages;
+}
+
+BenchResult run_bench(const string &name, const vector<string> &messages,
+                      const function<string(const string&)> &hash_func) {
+    size_t bytes = 0;
+    for (const string &m : messages) bytes += m.size();
+
+    volatile char sink = 0;
+    PERF_SCOPE(perf, name, messages.size());
+    auto start = high_resolution_clock::now();
+    for (const string &m : messages)
+        sink = sink ^ hash_func(m)[0];
+    auto end = high_resolution_clock::now();
+
+    double seconds = duration<double>(end - start).count();
+    BenchResult r;
+    r.name = name;
+    r.hashes = messages.size();
+    r.ns_per_hash = seconds * 1e9 / messages.size();
+    r.mb_per_s = bytes / seconds / 1e6;
+    return r;
+}
+
+// Mode XOF : debit de sortie (une seule absorption, puis 'bytes' octets extraits)
+BenchResult run_xof_bench(const string &name, size_t bytes,
+                          const function<void(uint8_t*, size_t)> &xof_func) {
+    vector<uint8_t> out(bytes);
+    PERF_SCOPE(perf, name, 1);
+    auto start = high_resolution_clock::now();
+    xof_func(out.data(), out.size());
+    auto end = high_resolution_clock::now();
+
+    double seconds = duration<double>(end - start).count();
+    BenchResult r;
+    r.name = name;
+    r.hashes = bytes;
+    r.ns_per_hash = seconds * 1e9 / bytes;
+    r.mb_per_s = bytes / seconds / 1e6;
+    return r;
+}
+
+void print_cpu_features() {
+    cout << "Noyaux disponibles :";
+#if defined(__x86_64__) && defined(__GNUC__)
+    __builtin_cpu_init();
+    cout << " x86-64";
+    if (__builtin_cpu_supports("avx2")) cout << " avx2";
+    if (__builtin_cpu_supports("avx512f")) cout << " avx512f";
+    if (__builtin_cpu_supports("bmi2")) cout << " bmi2";
+    cout << (ac_hash_plus_packed() ? " (AC-Hash+ empaquete)" : " (AC-Hash+ octet par cellule)");
+#else
+    cout << " generique";
+#endif
+    cout << "\n\n";
+}
+
+int main(int argc, char **argv) {
+    size_t count = (argc > 1) ? stoul(argv[1]) : 2000;
+    size_t xofMegabytes = (argc > 2) ? stoul(argv[2]) : 16;
+    const size_t MESSAGE_LENGTH = 64;
+
+    cout << "==============================================" << endl;
+    cout << "BENCHMARK LIBACHASH" << endl;
+    cout << "==============================================" << endl;
+    cout << "Messages: " << count << " x " << MESSAGE_LENGTH << " octets" << endl;
+    print_cpu_features();
+
+    vector<string> messages = make_messages(count, MESSAGE_LENGTH);
+
+    vector<pair<string, function<string(const string&)>>> kernels = {
+        {"sha256",          [](const string &m) { return sha256(m); }},
+        {"ac_hash_basic",   [](const string &m) { return ac_hash_basic(m, 110, 10); }},
+        {"ac_hash",         [](const string &m) { return ac_hash(m, 110, 10); }},
+        {"ac_hash_plus",    [](const string &m) { return ac_hash_plus(m, 110, 10); }}
+    };
+
+    vector<BenchResult> results;
+    for (const auto &k : kernels)
+        results.push_back(run_bench(k.first, messages, k.second));
+
+    cout << left << setw(18) << "Noyau" << right << setw(12) << "Hashs"
+         << setw(14) << "ns/hash" << setw(12) << "MB/s" << endl;
+    cout << string(56, '-') << endl;
+    cout << fixed << setprecision(1);
+    for (const BenchResult &r : results) {
+        cout << left << setw(18) << r.name << right << setw(12) << r.hashes
+             << setw(14) << r.ns_per_hash << setw(12) << setprecision(3) << r.mb_per_s
+             << setprecision(1) << endl;
+    }
+
+    // ---- Mode XOF (GB/s en sortie) ----
+    const string seed = messages.empty() ? string("benchmark") : messages[0];
+    vector<pair<string, function<void(uint8_t*, size_t)>>> xofs = {
+        {"ac_hash_xof",      [&](uint8_t *o, size_t n) { ac_hash_xof(seed, 110, 10, o, n); }},
+        {"ac_hash_plus_xof", [&](uint8_t *o, size_t n) { ac_hash_plus_xof(seed, 110, 10, o, n); }}
+    };
+
+    cout << "\n" << left << setw(18) << "Noyau XOF" << right << setw(12) << "Octets"
+         << setw(14) << "ns/octet" << setw(12) << "GB/s" << endl;
+    cout << string(56, '-') << endl;
+    for (const auto &x : xofs) {
+        BenchResult r = run_xof_bench(x.first, xofMegabytes << 20, x.second);
+        cout << left << setw(18) << r.name << right << setw(12) << r.hashes
+             << setw(14) << setprecision(3) << r.ns_per_hash << setw(12) << r.mb_per_s / 1e3
+             << setprecision(1) << endl;
+    }
+
+    PERF_REPORT();
+    return 0;
+}
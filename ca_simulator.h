@@ -0,0 +1,427 @@
+#ifndef CA_SIMULATOR_H
+#define CA_SIMULATOR_H
+
+// ==================== SIMULATEUR PARALLELE PAR TUILES ====================
+//
+// Anneau (ou segment a bords fixes) de n cellules empaquetees, double tampon.
+// Chaque thread possede une tuile de mots contigus (multiple de 8 mots, soit
+// une ligne de cache, pour que deux threads n'ecrivent jamais la meme ligne).
+// Une generation :
+//   1. chaque thread calcule les mots de sa tuile a partir du tampon courant ;
+//      ses mots de halo (dernier mot de la tuile de gauche, premier mot de
+//      celle de droite) sont lus dans ce tampon partage. Les rares mots dont
+//      la fenetre traverse l'extremite de l'anneau passent par ring_window
+//      (repli periodique ou bord fixe) ;
+//   2. barriere : la generation est complete partout, chaque thread passe a
+//      l'autre tampon.
+// Les threads sont crees une fois par run() ; la barriere est a attente
+// active (une generation d'un million de cellules dure ~100 us).
+//
+// Blocage temporel (BlockingPlan, depth = k > 1) : au lieu de parcourir tout
+// l'etat a chaque generation, chaque tuile de B mots est copiee avec un halo
+// de h = ceil(k r / 64) mots de chaque cote dans deux tampons locaux (tenant
+// en L1/L2), avancee de k generations sur place, puis ses B mots centraux sont
+// ecrits : k generations par passage en memoire. A l'etape s, seuls les mots
+// [s r / 64, M - s r / 64) sont recalcules (trapeze : la zone valide perd r
+// cellules de chaque cote par generation). Le calcul redondant vaut 2h / B.
+// tune_blocking() mesure quelques plans (B taille pour L1 ou L2, k = 4..64)
+// sur une portion de l'etat et garde le plus rapide.
+//
+// Plan 'multi' : dans chaque passage, les generations sont avancees K par K
+// avec la LUT multi-generations du moteur (step_words_multi, K = 4 pour
+// r = 1, 2 pour r = 2) : une consultation de table pour 8 cellules et K
+// generations. Les tuiles touchant un bord fixe restent generation par
+// generation (les cellules hors de l'etat doivent rester a 0).
+//
+// Evolution creuse (regles ou 000 -> 0) : tant que l'activite est confinee,
+// seul l'intervalle de mots actifs [lo, hi) est avance, avec un mot de marge
+// de chaque cote (le cone de lumiere avance de r <= 3 cellules par
+// generation), sur le thread appelant ; les mots de bord nuls sont retires
+// de l'intervalle. Retour au calcul complet (parallele) des que l'intervalle
+// depasse W / threads mots ou, sur un anneau, touche une extremite (l'activite
+// repasserait de l'autre cote). Les premieres generations d'un grand anneau
+// ensemence d'un seul 1 ne coutent presque rien.
+//
+// Regle additive (AdditiveRule : 90, 150, 60, 102...) : run() saute
+// directement a la generation voulue en O(n log t), sans iterer les noyaux
+// (desactivable par set_additive_jump(false), par exemple pour mesurer les
+// noyaux ou les verifier contre ce saut).
+
+#include "additive_rule.h"
+#include "cellular_automaton.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+/**
+ * Tailles des caches de donnees L1 et L2 en octets : sysconf de glibc si
+ * disponible, sinon (MinGW, macOS) ou si inconnues 32 Kio / 1 Mio.
+ */
+inline size_t l1_data_cache_bytes() {
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    long size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    if (size > 0) return static_cast<size_t>(size);
+#endif
+    return 32768;
+}
+
+inline size_t l2_cache_bytes() {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (size > 0) return static_cast<size_t>(size);
+#endif
+    return 1 << 20;
+}
+
+/**
+ * Barriere reutilisable a attente active (cede le CPU apres un moment, pour
+ * rester correcte si les threads sont plus nombreux que les coeurs)
+ */
+class SpinBarrier {
+private:
+    const unsigned count;
+    std::atomic<unsigned> waiting{0};
+    std::atomic<unsigned> phase{0};
+
+public:
+    explicit SpinBarrier(unsigned n) : count(n) {}
+
+    void wait() {
+        unsigned p = phase.load(std::memory_order_acquire);
+        if (waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+            waiting.store(0, std::memory_order_relaxed);
+            phase.store(p + 1, std::memory_order_release);
+            return;
+        }
+        for (unsigned spins = 0; phase.load(std::memory_order_acquire) == p; ++spins)
+            if (spins > 256) std::this_thread::yield();
+    }
+};
+
+struct BlockingPlan {
+    size_t tile_words = 0;   // B (multiple de 8)
+    size_t depth = 1;        // k generations par passage ; 1 : sans blocage
+    bool multi = false;      // LUT multi-generations dans chaque passage
+};
+
+template <int Radius>
+class ParallelSimulator {
+private:
+    CellularAutomaton<Radius> ca;
+    size_t n;
+    size_t W;
+    Boundary boundary;
+    unsigned threads;
+    std::vector<size_t> tiles;                 // tuile t : mots [tiles[t], tiles[t + 1])
+    // Tampons alignes sur 64 octets (new[] ne garantit que 16) : une tuile de
+    // 8k mots commence sur une ligne de cache
+    struct AlignedDelete {
+        void operator()(uint64_t *p) const { ::operator delete[](p, std::align_val_t(64)); }
+    };
+    std::unique_ptr<uint64_t[], AlignedDelete> buffers[2];    // non initialises : premier acces par le thread proprietaire
+
+    static uint64_t *allocate_words(size_t count) {
+        return static_cast<uint64_t *>(::operator new[](count * sizeof(uint64_t), std::align_val_t(64)));
+    }
+    int current = 0;
+    size_t generation_ = 0;
+    double seconds_ = 0;
+    double cell_updates_ = 0;   // cellules reellement calculees (creux : mots actifs seulement)
+    BlockingPlan plan;
+    AdditiveRule<Radius> additive;
+    bool additive_jump = true;
+
+    // Evolution creuse : mots actifs du tampon courant ; dirty[b] : mots
+    // ecrits lors du dernier passage creux dans le tampon b (hors : 0)
+    bool sparse = false;
+    size_t active_lo = 0, active_hi = 0;
+    size_t dirty_lo[2] = {0, 0}, dirty_hi[2] = {0, 0};
+    size_t sparse_generations_ = 0;
+
+    // Mot w "interieur" : sa fenetre (mots w - 1 .. w + 1) est dans [0, n)
+    bool interior(size_t w) const { return w >= 1 && 64 * (w + 2) <= n; }
+
+    // Mots [first, last) de la generation suivante ; out pointe sur le mot first
+    void step_tile(const uint64_t *in, uint64_t *out, size_t first, size_t last) const {
+        size_t w = first;
+        while (w < last) {
+            if (interior(w)) {
+                size_t end = w;
+                while (end < last && interior(end)) ++end;
+                ca.step_words(in + w - 1, out + (w - first), end - w);
+                w = end;
+            } else {
+                long long start = 64 * static_cast<long long>(w);
+                const uint64_t window[3] = {ring_window(in, n, start - 64, boundary),
+                                            ring_window(in, n, start, boundary),
+                                            ring_window(in, n, start + 64, boundary)};
+                ca.step_words(window, out + (w - first), 1);
+                ++w;
+            }
+        }
+        if (last == W && (n & 63)) out[last - 1 - first] &= (1ULL << (n & 63)) - 1;
+    }
+
+    // Cellules du mot global g qui appartiennent a [0, n)
+    uint64_t inside_mask(long long g) const {
+        if (g < 0 || 64 * g >= static_cast<long long>(n)) return 0;
+        size_t remaining = n - 64 * static_cast<size_t>(g);
+        return remaining >= 64 ? ~0ULL : (1ULL << remaining) - 1;
+    }
+
+    // Taille des tampons locaux de block_tile (mots)
+    static size_t block_buffer_words(size_t tile_words, size_t depth) {
+        return tile_words + 2 * ((depth * Radius + 63) / 64) + 2;
+    }
+
+    // Mots [w0, w1) avances de 'depth' generations (trapeze) ; out pointe sur
+    // le mot w0 ; a et b : block_buffer_words mots chacun
+    void block_tile(const uint64_t *in, uint64_t *out, size_t w0, size_t w1, size_t depth,
+                    uint64_t *a, uint64_t *b) const {
+        const size_t B = w1 - w0, h = (depth * Radius + 63) / 64, M = B + 2 * h;
+        const long long base = static_cast<long long>(w0) - static_cast<long long>(h);
+        const bool edge = base < 0 || 64 * (base + static_cast<long long>(M)) > static_cast<long long>(n);
+
+        // Mot local j en a[j + 1] ; a[0] et a[M + 1] : gardes
+        a[0] = a[M + 1] = b[0] = b[M + 1] = 0;
+        for (size_t j = 0; j < M; ++j) {
+            long long g = base + static_cast<long long>(j);
+            a[j + 1] = (g >= 0 && 64 * (g + 1) <= static_cast<long long>(n)) ? in[g] : ring_window(in, n, 64 * g, boundary);
+        }
+        const size_t K = CellularAutomaton<Radius>::multi_steps;
+        const bool multi = plan.multi && K > 1 && !(edge && boundary == Boundary::FIXED);
+        for (size_t step = 1; step <= depth;) {
+            // Generation atteinte apres ce calcul : step + K - 1 (LUT multi) ou step
+            size_t reached = (multi && step + K - 1 <= depth) ? step + K - 1 : step;
+            size_t lo = reached * Radius / 64, hi = M - lo;
+            if (reached != step) ca.step_words_multi(a + lo, b + lo + 1, hi - lo);
+            else ca.step_words(a + lo, b + lo + 1, hi - lo);
+            if (edge && boundary == Boundary::FIXED)
+                for (size_t j = lo; j < hi; ++j) b[j + 1] &= inside_mask(base + static_cast<long long>(j));
+            std::swap(a, b);
+            step = reached + 1;
+        }
+        std::copy(a + h + 1, a + h + 1 + B, out);
+        if (w1 == W && (n & 63)) out[B - 1] &= (1ULL << (n & 63)) - 1;
+    }
+
+    // Un passage de 'depth' generations : tuiles de la plage [first, last) du thread
+    void block_range(const uint64_t *in, uint64_t *out, size_t first, size_t last, size_t depth,
+                     std::vector<uint64_t> &scratch) const {
+        size_t words = block_buffer_words(plan.tile_words, depth);
+        scratch.resize(2 * words);
+        for (size_t w0 = first; w0 < last; w0 += plan.tile_words) {
+            size_t w1 = std::min(last, w0 + plan.tile_words);
+            block_tile(in, out + (w0 - first), w0, w1, depth, scratch.data(), scratch.data() + words);
+        }
+    }
+
+    /**
+     * Generations en mode creux, au plus 'generations' ; renvoie le nombre
+     * fait (moins si l'activite devient trop etendue : sparse passe a false).
+     */
+    size_t run_sparse(size_t generations) {
+        const size_t limit = std::max<size_t>(8, W / threads);
+        size_t done = 0;
+        while (sparse && done < generations) {
+            if (active_lo == active_hi) return generations;   // tout a 0 : etat fixe
+            size_t lo = active_lo > 0 ? active_lo - 1 : 0, hi = std::min(W, active_hi + 1);
+            if ((boundary == Boundary::PERIODIC && (lo == 0 || hi == W)) || hi - lo > limit) {
+                sparse = false;
+                break;
+            }
+            const int next = current ^ 1;
+            uint64_t *out = buffers[next].get();
+            for (size_t w = dirty_lo[next]; w < dirty_hi[next]; ++w)
+                if (w < lo || w >= hi) out[w] = 0;
+            step_tile(buffers[current].get(), out + lo, lo, hi);
+            cell_updates_ += 64.0 * (hi - lo);
+            dirty_lo[next] = lo;
+            dirty_hi[next] = hi;
+            while (lo < hi && out[lo] == 0) ++lo;
+            while (hi > lo && out[hi - 1] == 0) --hi;
+            active_lo = lo;
+            active_hi = hi;
+            current = next;
+            ++done;
+        }
+        return done;
+    }
+
+    // Execute f(t) sur les threads 1..T-1 et sur l'appelant (t = 0)
+    template <class F>
+    void parallel(F &&f) {
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) pool.emplace_back(f, t);
+        f(0u);
+        for (std::thread &th : pool) th.join();
+    }
+
+public:
+    ParallelSimulator(const CellularAutomaton<Radius> &automaton, size_t cells, unsigned thread_count = 0,
+                      Boundary b = Boundary::PERIODIC)
+        : ca(automaton), n(cells), W((cells + 63) / 64), boundary(b),
+          additive(AdditiveRule<Radius>::detect(automaton)) {
+        unsigned requested = thread_count ? thread_count : std::thread::hardware_concurrency();
+        if (requested == 0) requested = 1;
+        size_t lines = (W + 7) / 8;
+        threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(requested, lines)));
+        for (unsigned t = 0; t <= threads; ++t)
+            tiles.push_back(std::min(W, 8 * (lines * t / threads)));
+        buffers[0].reset(allocate_words(W + 1));
+        buffers[1].reset(allocate_words(W + 1));
+    }
+
+    size_t cells() const { return n; }
+    unsigned thread_count() const { return threads; }
+    size_t generation() const { return generation_; }
+    double seconds() const { return seconds_; }    // duree cumulee de run()
+    const CellularAutomaton<Radius> &automaton() const { return ca; }
+
+    // Cellules mises a jour par seconde (tous les run() ; en mode creux,
+    // seuls les mots de l'intervalle actif comptent)
+    double cell_updates_per_second() const { return seconds_ > 0 ? cell_updates_ / seconds_ : 0; }
+
+    void load(const PackedRing &state) {
+        parallel([&](unsigned t) {
+            for (int b = 0; b < 2; ++b)
+                for (size_t w = tiles[t]; w < tiles[t + 1]; ++w)
+                    buffers[b][w] = (b == current) ? state.words[w] : 0;
+        });
+        generation_ = 0;
+        seconds_ = 0;
+        cell_updates_ = 0;
+
+        sparse = !ca.output(0);
+        sparse_generations_ = 0;
+        active_lo = 0;
+        active_hi = W;
+        while (active_lo < active_hi && state.words[active_lo] == 0) ++active_lo;
+        while (active_hi > active_lo && state.words[active_hi - 1] == 0) --active_hi;
+        dirty_lo[current] = active_lo;
+        dirty_hi[current] = active_hi;
+        dirty_lo[current ^ 1] = dirty_hi[current ^ 1] = 0;
+    }
+
+    PackedRing state() const {
+        PackedRing ring(n);
+        std::copy(buffers[current].get(), buffers[current].get() + W, ring.words.begin());
+        return ring;
+    }
+
+    const BlockingPlan &blocking() const { return plan; }
+
+    // Generations calculees en mode creux (intervalle actif seulement)
+    size_t sparse_generations() const { return sparse_generations_; }
+    bool is_sparse() const { return sparse; }
+
+    // Saut en O(n log t) utilise par run() (regle additive, bords pris en charge)
+    bool uses_additive_jump() const { return additive_jump && additive.supports(boundary); }
+    void set_additive_jump(bool enabled) { additive_jump = enabled; }
+
+    void set_blocking(const BlockingPlan &p) {
+        plan = p;
+        if (plan.depth <= 1) plan = BlockingPlan();
+        else plan.tile_words = std::max<size_t>(8, plan.tile_words / 8 * 8);
+    }
+
+    /**
+     * Essaie sans blocage puis B pour L1 et L2 avec k = 4, 16, 64, avec et
+     * sans LUT multi-generations, sur une portion de l'etat courant (resultat
+     * jete), applique et renvoie le plus rapide. Interessant des que l'etat
+     * depasse nettement le cache, ou pour r = 2 (LUT multi-generations).
+     */
+    BlockingPlan tune_blocking() {
+        size_t l1_words = l1_data_cache_bytes() / 8, l2_words = l2_cache_bytes() / 8;
+        // Deux tampons locaux dans la moitie du cache
+        std::vector<BlockingPlan> candidates = {BlockingPlan()};
+        for (size_t cache : {l1_words, l2_words})
+            for (size_t depth : {4, 16, 64})
+                for (bool multi : {false, true})
+                    if (!multi || CellularAutomaton<Radius>::multi_steps > 1)
+                        candidates.push_back({std::max<size_t>(64, cache / 4 / 8 * 8), depth, multi});
+
+        const uint64_t *in = buffers[current].get();
+        size_t region = std::min(W, std::max<size_t>(2 * l2_words, 1 << 18));
+        size_t first = (W - region) / 2;
+        std::vector<uint64_t> out(region), scratch;
+        BlockingPlan best;
+        double best_cost = 0;
+        for (const BlockingPlan &candidate : candidates) {
+            BlockingPlan saved = plan;
+            set_blocking(candidate);
+            double cost = 0;
+            for (int trial = 0; trial < 2; ++trial) {   // meilleur de 2 essais
+                auto start = std::chrono::steady_clock::now();
+                if (plan.depth <= 1) step_tile(in, out.data(), first, first + region);
+                else block_range(in, out.data(), first, first + region, plan.depth, scratch);
+                double c = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() /
+                           (static_cast<double>(region) * plan.depth);
+                if (trial == 0 || c < cost) cost = c;
+            }
+            if (best_cost == 0 || cost < best_cost) {
+                best_cost = cost;
+                best = plan;
+            }
+            plan = saved;
+        }
+        set_blocking(best);
+        return plan;
+    }
+
+    void run(size_t generations) {
+        if (W == 0 || generations == 0) return;
+        if (uses_additive_jump()) {
+            auto start = std::chrono::steady_clock::now();
+            PackedRing next = additive.jump(state(), generations, boundary);
+            std::copy(next.words.begin(), next.words.end(), buffers[current].get());
+            sparse = false;   // intervalle actif perdu
+            seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            generation_ += generations;
+            cell_updates_ += n * static_cast<double>(generations);
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        if (sparse) {
+            size_t done = run_sparse(generations);
+            sparse_generations_ += done;
+            generation_ += done;
+            generations -= done;
+            if (generations == 0) {
+                seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                return;
+            }
+        }
+        SpinBarrier barrier(threads);
+        parallel([&](unsigned t) {
+            int cur = current;
+            std::vector<uint64_t> scratch;
+            for (size_t g = 0; g < generations;) {
+                const uint64_t *in = buffers[cur].get();
+                uint64_t *out = buffers[cur ^ 1].get() + tiles[t];
+                size_t depth = std::min(plan.depth, generations - g);
+                if (depth <= 1) step_tile(in, out, tiles[t], tiles[t + 1]);
+                else block_range(in, out, tiles[t], tiles[t + 1], depth, scratch);
+                barrier.wait();
+                cur ^= 1;
+                g += std::max<size_t>(depth, 1);
+            }
+        });
+        seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        size_t passes = plan.depth <= 1 ? generations : (generations + plan.depth - 1) / plan.depth;
+        current ^= static_cast<int>(passes & 1);
+        generation_ += generations;
+        cell_updates_ += n * static_cast<double>(generations);
+    }
+};
+
+#endif
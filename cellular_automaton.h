@@ -0,0 +1,366 @@
+#ifndef CELLULAR_AUTOMATON_H
+#define CELLULAR_AUTOMATON_H
+
+// ==================== AUTOMATE CELLULAIRE 1D GENERIQUE (r = 1..3) ====================
+//
+// CellularAutomaton<Radius> : voisinage de 2r + 1 cellules, regle donnee par
+// sa table de 2^(2r+1) bits (bit p = sortie du motif p, la cellule la plus a
+// gauche etant le bit de poids fort, comme la numerotation de Wolfram pour
+// r = 1) ou par un code totalistique (bit s = sortie si la somme vaut s).
+//
+// Deux representations de l'etat :
+//   - PackedRing : une cellule par bit, cellule i = bit (i & 63) du mot i >> 6 ;
+//   - lanes : une cellule par mot de 64 bits, bit l = simulation l (64
+//     automates independants evoluent ensemble, comme les lots de achash).
+//
+// Noyaux :
+//   - circuit : arbre de multiplexeurs sur les masques de la regle, de
+//     profondeur 2r + 1, deroule a la compilation ; 64 cellules par operation ;
+//   - totalistique : additionneur bit-slice (somme sur 3 bits) puis arbre
+//     de profondeur 3 ; par defaut pour les regles totalistiques, r >= 2 ;
+//   - LUT par octet : table de 2^(8+2r) entrees (fenetre de 8 + 2r cellules
+//     -> 8 cellules), construite avec la regle. Choisie par defaut pour
+//     r >= 2 (l'arbre a 31 ou 127 multiplexeurs) ; le circuit reste le plus
+//     rapide pour r = 1 (7 multiplexeurs pour 64 cellules).
+//   - LUT multi-generations : table de 2^(8+2Kr) entrees (fenetre de 8 + 2Kr
+//     cellules -> 8 cellules K generations plus tard ; K = 4 pour r = 1,
+//     2 pour r = 2, soit 64 Ko), construite avec la regle. step_words_multi
+//     avance de K generations par consultation ; utilisee par le blocage
+//     temporel du simulateur et par AC_HASH de base.
+// Les noyaux LUT supposent un CPU little-endian (x86-64, ARM).
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Sortie de la regle pour 64 cellules a la fois. x[0] = cellule la plus a
+// gauche (bit de poids fort du motif), x[Window - 1] = la plus a droite ;
+// masks[p] = sortie du motif p pour chacune des 64 positions (0 / ~0 pour une
+// regle commune, quelconque pour une regle differente par lane). Recursion a
+// la compilation : code sans boucle ni tableau intermediaire, vectorisable
+// dans les boucles sur les cellules.
+template <int Window>
+inline uint64_t ca_circuit(const uint64_t *masks, const uint64_t *x) {
+    if constexpr (Window == 0) {
+        return masks[0];
+    } else {
+        // x[0] choisit entre les motifs de bit de poids fort 0 et 1
+        uint64_t low = ca_circuit<Window - 1>(masks, x + 1);
+        uint64_t high = ca_circuit<Window - 1>(masks + (size_t(1) << (Window - 1)), x + 1);
+        return (x[0] & high) | (~x[0] & low);
+    }
+}
+
+enum class Boundary {
+    PERIODIC,   // anneau
+    FIXED       // cellules hors de l'intervalle a 0
+};
+
+enum class CaKernel { CIRCUIT, TOTALISTIC, LUT };
+
+inline const char *ca_kernel_name(CaKernel kernel) {
+    switch (kernel) {
+        case CaKernel::TOTALISTIC: return "totalistique";
+        case CaKernel::LUT:        return "LUT par octet";
+        default:                   return "circuit";
+    }
+}
+
+/**
+ * Etat empaquete de n cellules
+ */
+struct PackedRing {
+    size_t cells = 0;
+    std::vector<uint64_t> words;
+
+    PackedRing() = default;
+    explicit PackedRing(size_t n) : cells(n), words((n + 63) / 64, 0) {}
+
+    static PackedRing from_cells(const std::vector<int> &state) {
+        PackedRing ring(state.size());
+        for (size_t i = 0; i < state.size(); ++i)
+            if (state[i]) ring.set(i, true);
+        return ring;
+    }
+
+    bool get(size_t i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    void set(size_t i, bool v) {
+        if (v) words[i >> 6] |= 1ULL << (i & 63);
+        else words[i >> 6] &= ~(1ULL << (i & 63));
+    }
+
+    std::vector<int> to_cells() const {
+        std::vector<int> state(cells);
+        for (size_t i = 0; i < cells; ++i) state[i] = get(i);
+        return state;
+    }
+
+    std::string to_string(char zero = '0', char one = '1') const {
+        std::string row(cells, zero);
+        for (size_t i = 0; i < cells; ++i)
+            if (get(i)) row[i] = one;
+        return row;
+    }
+
+    size_t population() const {
+        size_t n = 0;
+        for (uint64_t w : words) n += __builtin_popcountll(w);
+        return n;
+    }
+
+    // Bits au-dela de la derniere cellule a 0 (invariant des noyaux)
+    uint64_t last_mask() const { return (cells & 63) ? (1ULL << (cells & 63)) - 1 : ~0ULL; }
+
+    bool operator==(const PackedRing &o) const { return cells == o.cells && words == o.words; }
+    bool operator!=(const PackedRing &o) const { return !(*this == o); }
+};
+
+// 64 cellules consecutives a partir de la cellule 'start' (negative ou
+// au-dela de n : repliee sur l'anneau, ou 0 pour des bords fixes)
+inline uint64_t ring_window(const uint64_t *words, size_t n, long long start, Boundary boundary) {
+    const long long cells = static_cast<long long>(n);
+    if (start >= 0 && start + 64 <= cells) {
+        size_t w = static_cast<size_t>(start) >> 6, r = static_cast<size_t>(start) & 63;
+        return r ? (words[w] >> r) | (words[w + 1] << (64 - r)) : words[w];
+    }
+    uint64_t v = 0;
+    for (int j = 0; j < 64; ++j) {
+        long long c = start + j;
+        if (c < 0 || c >= cells) {
+            if (boundary == Boundary::FIXED) continue;
+            c = ((c % cells) + cells) % cells;
+        }
+        v |= ((words[c >> 6] >> (c & 63)) & 1) << j;
+    }
+    return v;
+}
+
+template <int Radius, size_t RuleWidth = (size_t(1) << (2 * Radius + 1))>
+class CellularAutomaton {
+    static_assert(Radius >= 1 && Radius <= 3, "rayon 1 a 3");
+    static_assert(RuleWidth == (size_t(1) << (2 * Radius + 1)), "table de 2^(2r+1) bits");
+
+public:
+    static constexpr int radius = Radius;
+    static constexpr int window = 2 * Radius + 1;
+    static constexpr size_t rule_width = RuleWidth;
+    static constexpr size_t rule_words = (RuleWidth + 63) / 64;
+    typedef std::array<uint64_t, rule_words> RuleTable;   // bit p = sortie du motif p
+    static constexpr int multi_steps = Radius == 1 ? 4 : (Radius == 2 ? 2 : 1);   // K
+
+private:
+    static constexpr size_t LUT_BITS = 8 + 2 * Radius;
+    static constexpr size_t MULTI_BITS = 8 + 2 * multi_steps * Radius;
+
+    RuleTable table{};
+    uint64_t masks[RuleWidth];
+    uint64_t sum_masks[8] = {};       // totalistique : sortie pour une somme s
+    bool totalistic_ = false;
+    CaKernel kernel_ = CaKernel::CIRCUIT;
+    std::vector<uint8_t> lut;
+    std::vector<uint8_t> multi_lut;
+
+    void build_masks() {
+        for (size_t p = 0; p < RuleWidth; ++p)
+            masks[p] = output(static_cast<uint32_t>(p)) ? ~0ULL : 0ULL;
+    }
+
+    void build_lut() {
+        lut.assign(size_t(1) << LUT_BITS, 0);
+        for (size_t w = 0; w < lut.size(); ++w) {
+            uint8_t out = 0;
+            for (int b = 0; b < 8; ++b) {
+                // fenetre : bit j = cellule (b - r + j) de l'octet, j = 0 a gauche
+                uint32_t pattern = 0;
+                for (int j = 0; j < window; ++j)
+                    pattern = (pattern << 1) | ((w >> (b + j)) & 1);
+                out |= static_cast<uint8_t>(output(pattern) << b);
+            }
+            lut[w] = out;
+        }
+    }
+
+    void build_multi_lut() {
+        if (multi_steps == 1) return;
+        multi_lut.assign(size_t(1) << MULTI_BITS, 0);
+        for (size_t w = 0; w < multi_lut.size(); ++w) {
+            // Cellule j de la fenetre = bit j ; la zone valide perd r cellules par generation
+            uint64_t cells = w, x[window];
+            for (int s = 0; s < multi_steps; ++s) {
+                for (int k = 0; k < window; ++k) {
+                    int d = k - Radius;
+                    x[k] = d >= 0 ? cells >> d : cells << -d;
+                }
+                cells = ca_circuit<window>(masks, x);
+            }
+            multi_lut[w] = static_cast<uint8_t>(cells >> (multi_steps * Radius));
+        }
+    }
+
+    // Mot de 64 cellules commencant a la cellule 64 * w + d (ext : un mot de
+    // halo de chaque cote, ext[w + 1] = mot w de l'etat)
+    static uint64_t shifted(const uint64_t *ext, size_t w, int d) {
+        if (d == 0) return ext[w + 1];
+        if (d > 0) return (ext[w + 1] >> d) | (ext[w + 2] << (64 - d));
+        return (ext[w + 1] << -d) | (ext[w] >> (64 + d));
+    }
+
+    uint64_t apply_totalistic(const uint64_t *x) const {
+        // Somme de 2r + 1 bits en bit-slice : s0 + 2 s1 + 4 s2
+        uint64_t s0 = 0, s1 = 0, s2 = 0;
+        for (int k = 0; k < window; ++k) {
+            uint64_t c0 = s0 & x[k];
+            s0 ^= x[k];
+            uint64_t c1 = s1 & c0;
+            s1 ^= c0;
+            s2 |= c1;
+        }
+        uint64_t sum[3] = {s2, s1, s0};
+        return ca_circuit<3>(sum_masks, sum);
+    }
+
+    CellularAutomaton(const RuleTable &rule_table, CaKernel k) : table(rule_table) {
+        build_masks();
+        build_multi_lut();
+        use_kernel(k);
+    }
+
+public:
+    explicit CellularAutomaton(const RuleTable &rule_table)
+        : CellularAutomaton(rule_table, Radius >= 2 ? CaKernel::LUT : CaKernel::CIRCUIT) {}
+
+    // Regle numerotee (bit p = sortie du motif p), r <= 2 : 8 ou 32 bits
+    static CellularAutomaton from_number(uint64_t rule) {
+        RuleTable t{};
+        t[0] = (RuleWidth >= 64) ? rule : rule & ((1ULL << RuleWidth) - 1);
+        return CellularAutomaton(t);
+    }
+
+    // Regle totalistique : la sortie ne depend que de la somme du voisinage
+    static CellularAutomaton totalistic(uint32_t code) {
+        RuleTable t{};
+        for (size_t p = 0; p < RuleWidth; ++p)
+            if ((code >> __builtin_popcountll(p)) & 1) t[p >> 6] |= 1ULL << (p & 63);
+        CellularAutomaton ca(t, CaKernel::CIRCUIT);
+        for (int s = 0; s < 8; ++s)
+            ca.sum_masks[s] = (s <= window && ((code >> s) & 1)) ? ~0ULL : 0ULL;
+        ca.totalistic_ = true;
+        if (Radius >= 2) ca.use_kernel(CaKernel::TOTALISTIC);
+        return ca;
+    }
+
+    const RuleTable &rule_table() const { return table; }
+    bool output(uint32_t pattern) const { return (table[pattern >> 6] >> (pattern & 63)) & 1; }
+    const uint64_t *rule_masks() const { return masks; }
+
+    bool is_totalistic() const { return totalistic_; }
+    CaKernel kernel() const { return kernel_; }
+
+    // Le noyau totalistique n'existe que pour une regle totalistic()
+    void use_kernel(CaKernel k) {
+        if (k == CaKernel::TOTALISTIC && !totalistic_) k = CaKernel::CIRCUIT;
+        kernel_ = k;
+        if (k == CaKernel::LUT && lut.empty()) build_lut();
+    }
+
+    // 64 cellules : x[0..window-1] = voisins de gauche a droite
+    uint64_t apply(const uint64_t *x) const {
+        return (totalistic_ && kernel_ != CaKernel::CIRCUIT) ? apply_totalistic(x) : ca_circuit<window>(masks, x);
+    }
+
+    // Mots out[0..count) de la generation suivante ; ext[0] = mot precedent,
+    // ext[1..count] = mots courants, ext[count + 1] = mot suivant (cellules
+    // contigues, halos compris). Base des simulateurs par tuiles.
+    void step_words(const uint64_t *ext, uint64_t *out, size_t count) const {
+        if (kernel_ == CaKernel::LUT) {
+            const uint8_t *bytes = reinterpret_cast<const uint8_t *>(ext);
+            uint8_t *dst = reinterpret_cast<uint8_t *>(out);
+            const uint32_t mask = (1u << LUT_BITS) - 1;
+            for (size_t b = 0; b < 8 * count; ++b) {
+                // cellules 8b - r .. 8b + 7 + r : octets b + 7 .. b + 9 de ext
+                uint32_t v = bytes[b + 7] | (bytes[b + 8] << 8) | (bytes[b + 9] << 16);
+                dst[b] = lut[(v >> (8 - Radius)) & mask];
+            }
+        } else {
+            uint64_t x[window];
+            for (size_t w = 0; w < count; ++w) {
+                for (int k = 0; k < window; ++k) x[k] = shifted(ext, w, k - Radius);
+                out[w] = apply(x);
+            }
+        }
+    }
+
+    // Comme step_words, mais multi_steps generations d'un coup (K r <= 8 :
+    // les halos d'un mot suffisent). Les cellules hors de l'etat evoluent
+    // selon la regle : bords fixes exacts seulement loin des extremites.
+    void step_words_multi(const uint64_t *ext, uint64_t *out, size_t count) const {
+        static_assert(multi_steps * Radius <= 8, "fenetre de 3 octets");
+        if (multi_steps == 1) {
+            step_words(ext, out, count);
+            return;
+        }
+        const uint64_t mask = (1u << MULTI_BITS) - 1;
+        const uint8_t *table = multi_lut.data();
+        for (size_t w = 0; w < count; ++w) {
+            // cellules 64w - Kr .. 64w + 63 + Kr : mots w .. w + 2 de ext
+            const uint64_t lo = ext[w + 1], prev = ext[w], next = ext[w + 2];
+            const int h = multi_steps * Radius;
+            uint64_t result = 0;
+            result |= table[((lo << h) | (prev >> (64 - h))) & mask];
+            for (int b = 1; b < 7; ++b) result |= static_cast<uint64_t>(table[(lo >> (8 * b - h)) & mask]) << (8 * b);
+            result |= static_cast<uint64_t>(table[((lo >> (56 - h)) | (next << (8 + h))) & mask]) << 56;
+            out[w] = result;
+        }
+    }
+
+    // Une generation : out = f(in) (in et out distincts, meme taille)
+    void step(const PackedRing &in, PackedRing &out, Boundary boundary = Boundary::PERIODIC) const {
+        const size_t n = in.cells, W = in.words.size();
+        out.cells = n;
+        out.words.resize(W);
+        if (n == 0) return;
+
+        std::vector<uint64_t> ext(W + 2, 0);
+        for (size_t w = 0; w < W; ++w) ext[w + 1] = in.words[w];
+        if (boundary == Boundary::PERIODIC) {
+            // Halo : les r cellules de l'autre extremite de l'anneau
+            for (int j = 1; j <= Radius; ++j) {
+                size_t left = (n * Radius - j) % n, right = (j - 1) % n;
+                size_t lpos = 64 - j, rpos = 64 + n + j - 1;   // positions dans ext
+                ext[lpos >> 6] |= static_cast<uint64_t>(in.get(left)) << (lpos & 63);
+                ext[rpos >> 6] |= static_cast<uint64_t>(in.get(right)) << (rpos & 63);
+            }
+        }
+
+        step_words(ext.data(), out.words.data(), W);
+        out.words[W - 1] &= in.last_mask();
+    }
+
+    void evolve(PackedRing &state, size_t generations, Boundary boundary = Boundary::PERIODIC) const {
+        PackedRing next(state.cells);
+        for (size_t g = 0; g < generations; ++g) {
+            step(state, next, boundary);
+            std::swap(state, next);
+        }
+    }
+
+    // 64 automates : cellule i = mot in[i], bit l = lane l
+    void step_lanes(const uint64_t *in, uint64_t *out, size_t n, Boundary boundary = Boundary::PERIODIC) const {
+        uint64_t x[window];
+        for (size_t i = 0; i < n; ++i) {
+            for (int k = 0; k < window; ++k) {
+                long long j = static_cast<long long>(i) + k - Radius;
+                if (j >= 0 && j < static_cast<long long>(n)) x[k] = in[j];
+                else if (boundary == Boundary::FIXED) x[k] = 0;
+                else x[k] = in[(j % static_cast<long long>(n) + n) % n];
+            }
+            out[i] = apply(x);
+        }
+    }
+};
+
+typedef CellularAutomaton<1> ElementaryAutomaton;
+
+#endif
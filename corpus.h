@@ -0,0 +1,205 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+// ==================== CORPUS DE MESSAGES DE TEST ====================
+//
+// Remplace generate_random_message / flip_random_bit (un random_device et un
+// mt19937 construits a chaque appel, puis une chaine construite octet par
+// octet). Les messages de longueur fixe sont generes par paquets dans une
+// zone contigue (arena) et lus via std::string_view ; aucun appel systeme ni
+// allocation par message.
+//
+// Reproductibilite : le message i depend seulement de (graine, flux, i). Il
+// est produit par un xoshiro256** initialise pour le paquet i / CORPUS_BLOCK,
+// donc identique quel que soit l'ordre ou le thread qui le genere.
+//
+// Selection a l'execution : AC_CORPUS=printable|random|counter|lowweight|pattern
+// et AC_SEED=<graine> (defaut : printable, 2024).
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+const size_t CORPUS_BLOCK = 256;   // messages par paquet d'initialisation
+
+/**
+ * xoshiro256** (Blackman & Vigna) : 4 mots d'etat, quelques operations par
+ * sortie de 64 bits. Etat initialise par SplitMix64 a partir de (graine, flux).
+ */
+class Xoshiro256 {
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    static uint64_t splitmix(uint64_t &x) {
+        uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+public:
+    explicit Xoshiro256(uint64_t seed, uint64_t stream = 0) {
+        uint64_t x = seed;
+        uint64_t key = splitmix(x) ^ stream * 0xd1342543de82ef95ULL;
+        for (uint64_t &w : s) w = splitmix(key);
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // Entier dans [0, bound) (multiplication 64 x 64 -> 128, biais negligeable)
+    uint64_t below(uint64_t bound) {
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(next()) * bound) >> 64);
+    }
+};
+
+enum class CorpusKind {
+    PRINTABLE,   // octets ASCII 32..126 (comme l'ancien generate_random_message)
+    RANDOM,      // octets uniformes 0..255
+    COUNTER,     // graine puis compteur (flux << 48 | i) en big-endian, reste a zero
+    LOW_WEIGHT,  // message nul avec 1 a 3 bits a 1
+    PATTERN      // motif aleatoire de 1 a 8 octets repete
+};
+
+inline const char *corpus_kind_name(CorpusKind kind) {
+    switch (kind) {
+        case CorpusKind::RANDOM:     return "random";
+        case CorpusKind::COUNTER:    return "counter";
+        case CorpusKind::LOW_WEIGHT: return "lowweight";
+        case CorpusKind::PATTERN:    return "pattern";
+        default:                     return "printable";
+    }
+}
+
+inline CorpusKind corpus_kind_from_name(const std::string &name) {
+    if (name == "random") return CorpusKind::RANDOM;
+    if (name == "counter") return CorpusKind::COUNTER;
+    if (name == "lowweight") return CorpusKind::LOW_WEIGHT;
+    if (name == "pattern") return CorpusKind::PATTERN;
+    return CorpusKind::PRINTABLE;
+}
+
+inline CorpusKind corpus_kind_from_env() {
+    const char *name = std::getenv("AC_CORPUS");
+    return name ? corpus_kind_from_name(name) : CorpusKind::PRINTABLE;
+}
+
+inline uint64_t corpus_seed_from_env() {
+    const char *seed = std::getenv("AC_SEED");
+    return seed ? std::strtoull(seed, nullptr, 10) : 2024;
+}
+
+/**
+ * Messages de longueur fixe dans une arena contigue. fill() genere une plage
+ * d'index ; next() parcourt les messages 0, 1, 2, ... en regenerant l'arena
+ * par paquets de CORPUS_BLOCK. Chaque corpus (un par thread) a son propre
+ * generateur auxiliaire rng() pour les tirages annexes (bit a inverser...).
+ */
+class MessageCorpus {
+private:
+    CorpusKind kind;
+    size_t length;
+    uint64_t seed;
+    uint64_t stream;
+    std::vector<char> arena;
+    uint64_t first = 0;      // index du premier message de l'arena
+    size_t count = 0;        // messages presents dans l'arena
+    uint64_t cursor = 0;     // prochain index rendu par next()
+    Xoshiro256 auxiliary;
+
+    void generate(Xoshiro256 &rng, uint64_t index, char *out) const {
+        switch (kind) {
+            case CorpusKind::PRINTABLE:
+            case CorpusKind::RANDOM:
+                for (size_t k = 0; k < length; k += 8) {
+                    uint64_t r = rng.next();
+                    for (size_t b = k; b < length && b < k + 8; b++, r >>= 8) {
+                        uint8_t byte = static_cast<uint8_t>(r);
+                        out[b] = static_cast<char>(kind == CorpusKind::RANDOM ? byte : 32 + ((byte * 95u) >> 8));
+                    }
+                }
+                break;
+            case CorpusKind::COUNTER: {
+                // Flux dans les 16 bits de poids fort : flux disjoints tant que i < 2^48
+                uint64_t counter = index ^ (stream << 48);
+                std::memset(out, 0, length);
+                for (size_t b = 0; b < 8 && b < length; b++) out[b] = static_cast<char>(seed >> (56 - 8 * b));
+                for (size_t b = 0; b < 8 && 8 + b < length; b++) out[8 + b] = static_cast<char>(counter >> (56 - 8 * b));
+                break;
+            }
+            case CorpusKind::LOW_WEIGHT:
+                std::memset(out, 0, length);
+                for (uint64_t w = 0; length > 0 && w < 1 + index % 3; w++) {
+                    uint64_t bit = rng.below(8 * length);
+                    out[bit / 8] |= static_cast<char>(1 << (bit % 8));
+                }
+                break;
+            case CorpusKind::PATTERN: {
+                uint64_t motif = rng.next();
+                size_t period = 1 + static_cast<size_t>(rng.below(8));
+                for (size_t b = 0; b < length; b++) out[b] = static_cast<char>(motif >> (8 * (b % period)));
+                break;
+            }
+        }
+    }
+
+public:
+    MessageCorpus(CorpusKind kind, size_t length, uint64_t seed, uint64_t stream = 0)
+        : kind(kind), length(length), seed(seed), stream(stream), auxiliary(seed, ~stream) {}
+
+    // Messages [from, from + n) dans l'arena
+    void fill(uint64_t from, size_t n) {
+        arena.resize(n * length);
+        first = from;
+        count = n;
+        uint64_t block = from / CORPUS_BLOCK;
+        Xoshiro256 rng(seed ^ stream * 0x9e3779b97f4a7c15ULL, block);
+        // Les messages qui precedent 'from' dans son paquet sont generes puis jetes
+        std::vector<char> skipped(length);
+        for (uint64_t i = block * CORPUS_BLOCK; i < from; i++) generate(rng, i, skipped.data());
+        for (uint64_t i = from; i < from + n; i++) {
+            if (i % CORPUS_BLOCK == 0 && i != block * CORPUS_BLOCK)
+                rng = Xoshiro256(seed ^ stream * 0x9e3779b97f4a7c15ULL, i / CORPUS_BLOCK);
+            generate(rng, i, arena.data() + (i - from) * length);
+        }
+    }
+
+    std::string_view operator[](size_t i) const { return std::string_view(arena.data() + i * length, length); }
+    size_t size() const { return count; }
+    size_t messageLength() const { return length; }
+    CorpusKind corpusKind() const { return kind; }
+
+    // Message suivant (index cursor), regenere l'arena par paquets
+    std::string_view next() {
+        if (cursor < first || cursor >= first + count) fill(cursor - cursor % CORPUS_BLOCK, CORPUS_BLOCK);
+        std::string_view m = (*this)[cursor - first];
+        cursor++;
+        return m;
+    }
+
+    Xoshiro256 &rng() { return auxiliary; }
+};
+
+// Inverse un bit tire au hasard (sur place) ; renvoie sa position
+inline uint64_t flip_random_bit(std::string &message, Xoshiro256 &rng) {
+    if (message.empty()) return 0;
+    uint64_t bit = rng.below(8 * message.size());
+    message[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+    return bit;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#include "base_funcs.h"
+#include "/root/repo/achash.h"
+int main(){
+  mt19937_64 g(1); int bad=0;
+  uint32_t rules[]={0,1,30,45,60,90,102,105,110,150,184,204,255,300};
+  for(int it=0;it<3000;it++){
+    size_t len=g()%130; string m(len,0); for(auto&c:m) c=(char)g();
+    uint32_t r=rules[g()%14]; size_t st=g()%40;
+    if(B2::ac_hash(m,r,st)!=ac_hash_basic(m,r,st)){bad++; if(bad<5) printf("basic mismatch len=%zu r=%u st=%zu\n",len,r,st);}
+    if(B3::ac_hash(m,r,st)!=ac_hash(m,r,st)){bad++; if(bad<5) printf("ac mismatch len=%zu r=%u st=%zu\n",len,r,st);}
+    if(B10::ac_hash_plus(m,r,st)!=ac_hash_plus(m,r,st)){bad++; if(bad<5) printf("plus mismatch len=%zu r=%u st=%zu\n",len,r,st);}
+  }
+  for(int it=0;it<300;it++){ int n=3+g()%200; vector<int> s(n); for(auto&x:s)x=g()&1; int r=g()%256; if(B1::evolve(s,r)!=evolve(s,r)) bad++;}
+  // batch
+  for(int it=0;it<20;it++){
+    size_t cnt=1+g()%150; vector<string> ms(cnt); for(auto&m:ms){m.resize(g()%4 *20 + g()%3); for(auto&c:m)c=(char)g();}
+    uint32_t r=rules[g()%13]; size_t st=1+g()%30;
+    vector<Digest256> o1(cnt),o2(cnt); ac_hash_digest_batch(ms.data(),cnt,r,st,o1.data()); ac_hash_plus_digest_batch(ms.data(),cnt,r,st,o2.data());
+    for(size_t i=0;i<cnt;i++){ if(digest_to_hex(o1[i])!=B3::ac_hash(ms[i],r,st)){bad++;printf("batch ac\n");} if(digest_to_hex(o2[i])!=B10::ac_hash_plus(ms[i],r,st)){bad++;printf("batch plus\n");}}
+    vector<size_t> sc={0,5,1,17,5,3,40}; vector<Digest256> s1(cnt*sc.size()),s2(cnt*sc.size());
+    ac_hash_step_sweep(ms.data(),cnt,r,sc.data(),sc.size(),s1.data());
+    ac_hash_plus_step_sweep(ms.data(),cnt,r,sc.data(),sc.size(),s2.data());
+    for(size_t k=0;k<sc.size();k++) for(size_t i=0;i<cnt;i++){
+      if(digest_to_hex(s1[k*cnt+i])!=B3::ac_hash(ms[i],r,sc[k])){bad++; if(bad<20)printf("sweep ac len=%zu st=%zu\n",ms[i].size(),sc[k]);}
+      if(digest_to_hex(s2[k*cnt+i])!=B10::ac_hash_plus(ms[i],r,sc[k])){bad++; if(bad<20)printf("sweep plus len=%zu st=%zu\n",ms[i].size(),sc[k]);}
+    }
+  }
+  // xof block0
+  for(int it=0;it<50;it++){ string m="abc"+to_string(it); uint8_t o[100]; ac_hash_xof(m,30,10,o,100); string h=B3::ac_hash(m,30,10);
+     char buf[3]; string p; for(int i=0;i<16;i++){sprintf(buf,"%02x",o[i]);p+=buf;} if(p!=h.substr(0,32)){bad++;printf("xof\n");}
+     uint8_t o2[100]; AcHashXof x(AcHashXof::AC_HASH,m,30,10); for(int i=0;i<100;i+=7) x.squeeze(o2+i,min(7,100-i)); if(memcmp(o,o2,100)){bad++;printf("xof chunk\n");}
+     ac_hash_plus_xof(m,30,10,o,100); p=""; for(int i=0;i<32;i++){sprintf(buf,"%02x",o[i]);p+=buf;} if(p!=B10::ac_hash_plus(m,30,10)){bad++;printf("xofp\n");}
+  }
+  printf("packed=%d bad=%d\n",ac_hash_plus_packed(),bad);
+}
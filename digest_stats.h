@@ -0,0 +1,186 @@
+#ifndef DIGEST_STATS_H
+#define DIGEST_STATS_H
+
+// ==================== STATISTIQUES SUR EMPREINTES BRUTES ====================
+//
+// Noyaux de comptage pour les tests statistiques (exercices 5, 6, 7, 10) :
+// ils travaillent directement sur Digest256 (4 x 64 bits) avec popcount, sans
+// repasser par la chaine hexadecimale. Position j d'une empreinte = j-ieme bit
+// de la chaine hexadecimale (MSB first), soit le bit 63 - j%64 du mot j/64.
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "achash.h"
+
+const int DIGEST_BITS = 256;
+const int DIGEST_BYTES = 32;
+
+inline int digest_ones(const Digest256 &d) {
+    return __builtin_popcountll(d[0]) + __builtin_popcountll(d[1]) +
+           __builtin_popcountll(d[2]) + __builtin_popcountll(d[3]);
+}
+
+inline int digest_hamming(const Digest256 &a, const Digest256 &b) {
+    return __builtin_popcountll(a[0] ^ b[0]) + __builtin_popcountll(a[1] ^ b[1]) +
+           __builtin_popcountll(a[2] ^ b[2]) + __builtin_popcountll(a[3] ^ b[3]);
+}
+
+inline int digest_bit(const Digest256 &d, int position) {
+    return static_cast<int>((d[position >> 6] >> (63 - (position & 63))) & 1);
+}
+
+// Octet k de l'empreinte (ordre de la chaine hexadecimale)
+inline uint8_t digest_byte(const Digest256 &d, int k) {
+    return static_cast<uint8_t>(d[k >> 3] >> (56 - 8 * (k & 7)));
+}
+
+/**
+ * Chaine hexadecimale (64 caracteres, ex: sha256) -> empreinte brute.
+ * Caracteres manquants ou invalides comptes comme 0.
+ */
+inline Digest256 hex_to_digest(const std::string &hex) {
+    Digest256 d = {0, 0, 0, 0};
+    size_t n = hex.size() < 64 ? hex.size() : 64;
+    for (size_t i = 0; i < n; i++) {
+        char c = hex[i];
+        uint64_t v = (c >= '0' && c <= '9') ? c - '0'
+                   : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                   : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : 0;
+        d[i >> 4] |= v << (60 - 4 * (i & 15));
+    }
+    return d;
+}
+
+/**
+ * Compteurs verticaux par position (bit-slicing) : le plan k contient le bit
+ * k du compteur de chacune des 256 positions. Ajouter une empreinte est une
+ * addition a retenue propagee sur les plans (demi-additionneurs bit a bit,
+ * comme dans Harley-Seal), soit ~2 plans touches en moyenne au lieu de 256
+ * increments. Les plans sont vides dans les compteurs 64 bits avant debordement.
+ */
+class BitPositionCounter {
+private:
+    static const int PLANES = 16;                 // vidage toutes les 2^16 - 1 empreintes
+    uint64_t planes[PLANES][4];
+    uint32_t pending;
+    uint64_t totals[DIGEST_BITS];
+    uint64_t digests;
+
+    void flush() {
+        for (int w = 0; w < 4; w++)
+            for (int b = 0; b < 64; b++) {
+                uint64_t count = 0;
+                for (int k = 0; k < PLANES; k++)
+                    count |= ((planes[k][w] >> (63 - b)) & 1) << k;
+                totals[64 * w + b] += count;
+            }
+        memset(planes, 0, sizeof(planes));
+        pending = 0;
+    }
+
+public:
+    BitPositionCounter() { reset(); }
+
+    void reset() {
+        memset(planes, 0, sizeof(planes));
+        memset(totals, 0, sizeof(totals));
+        pending = 0;
+        digests = 0;
+    }
+
+    void add(const Digest256 &d) {
+        for (int w = 0; w < 4; w++) {
+            uint64_t carry = d[w];
+            for (int k = 0; carry && k < PLANES; k++) {
+                uint64_t next = planes[k][w] & carry;
+                planes[k][w] ^= carry;
+                carry = next;
+            }
+        }
+        digests++;
+        if (++pending == (1u << PLANES) - 1) flush();
+    }
+
+    uint64_t count() const { return digests; }
+
+    // Nombre de 1 a chaque position (vide les plans en attente)
+    const uint64_t *ones() {
+        if (pending) flush();
+        return totals;
+    }
+};
+
+/**
+ * Histogramme des valeurs d'octets, par position d'octet dans l'empreinte
+ */
+struct ByteHistogram {
+    uint64_t counts[DIGEST_BYTES][256] = {};
+    uint64_t digests = 0;
+
+    void add(const Digest256 &d) {
+        for (int k = 0; k < DIGEST_BYTES; k++) counts[k][digest_byte(d, k)]++;
+        digests++;
+    }
+
+    // Chi-carre (255 ddl) de la position k, ou de toutes les positions si k < 0
+    double chiSquared(int k = -1) const {
+        double chi2 = 0;
+        double expected = (k < 0 ? digests * DIGEST_BYTES : digests) / 256.0;
+        if (expected == 0) return 0;
+        for (int v = 0; v < 256; v++) {
+            uint64_t observed = 0;
+            if (k < 0) {
+                for (int p = 0; p < DIGEST_BYTES; p++) observed += counts[p][v];
+            } else {
+                observed = counts[k][v];
+            }
+            chi2 += (observed - expected) * (observed - expected) / expected;
+        }
+        return chi2;
+    }
+};
+
+// ---------------------------- Lois de reference ----------------------------
+
+/**
+ * Fonction gamma incomplete reguliere superieure Q(a, x)
+ * (serie pour x < a + 1, fraction continue sinon)
+ */
+inline double gamma_q(double a, double x) {
+    if (x <= 0) return 1.0;
+    double lg = std::lgamma(a);
+    int iterations = 1000 + static_cast<int>(10 * std::sqrt(a));   // convergence en O(sqrt(a))
+    if (x < a + 1) {
+        double term = 1.0 / a, sum = term;
+        for (int n = 1; n < iterations; n++) {
+            term *= x / (a + n);
+            sum += term;
+            if (std::fabs(term) < std::fabs(sum) * 1e-15) break;
+        }
+        return 1.0 - sum * std::exp(-x + a * std::log(x) - lg);
+    }
+    const double TINY = 1e-300;
+    double b = x + 1 - a, c = 1 / TINY, d = 1 / b, h = d;
+    for (int n = 1; n < iterations; n++) {
+        double an = -n * (n - a);
+        b += 2;
+        d = an * d + b;
+        if (std::fabs(d) < TINY) d = TINY;
+        c = b + an / c;
+        if (std::fabs(c) < TINY) c = TINY;
+        d = 1 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1) < 1e-15) break;
+    }
+    return std::exp(-x + a * std::log(x) - lg) * h;
+}
+
+// p-value d'un chi-carre a 'dof' degres de liberte
+inline double chi2_pvalue(double chi2, int dof) {
+    return gamma_q(dof / 2.0, chi2 / 2.0);
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef HASH_CONFIG_H
+#define HASH_CONFIG_H
+
+// ==================== CONFIGURATION AC_HASH (FICHIER) ====================
+//
+// Parametres (variante, regle, etapes) choisis par l'autotuneur et relus par
+// compute_hash dans les exercices 3 et 4. Format texte "cle=valeur", une
+// cle par ligne, '#' pour les commentaires :
+//
+//     variant=ac          (ac | plus)
+//     rule=110
+//     steps=3
+//
+// Chemin : variable d'environnement AC_HASH_CONFIG, sinon "achash.conf".
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+struct HashConfig {
+    bool plus = false;      // ac_hash_plus au lieu de ac_hash
+    uint32_t rule = 110;
+    size_t steps = 3;
+};
+
+inline std::string hash_config_path() {
+    const char *path = std::getenv("AC_HASH_CONFIG");
+    return path ? path : "achash.conf";
+}
+
+/**
+ * Lit le fichier ; renvoie false (cfg inchange) s'il est absent ou invalide.
+ */
+inline bool load_hash_config(HashConfig &cfg, const std::string &path = hash_config_path()) {
+    std::ifstream in(path);
+    if (!in) return false;
+
+    HashConfig loaded;
+    bool hasRule = false, hasSteps = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = line.substr(0, eq), value = line.substr(eq + 1);
+        try {
+            if (key == "variant") {
+                if (value != "ac" && value != "plus") return false;
+                loaded.plus = (value == "plus");
+            } else if (key == "rule") {
+                loaded.rule = static_cast<uint32_t>(std::stoul(value));
+                hasRule = loaded.rule < 256;
+            } else if (key == "steps") {
+                loaded.steps = std::stoul(value);
+                hasSteps = true;
+            }
+        } catch (const std::exception &) {
+            return false;
+        }
+    }
+    if (!hasRule || !hasSteps) return false;
+    cfg = loaded;
+    return true;
+}
+
+inline bool save_hash_config(const HashConfig &cfg, const std::string &comment,
+                             const std::string &path = hash_config_path()) {
+    std::ofstream out(path);
+    if (!out) return false;
+    if (!comment.empty()) out << "# " << comment << "\n";
+    out << "variant=" << (cfg.plus ? "plus" : "ac") << "\n";
+    out << "rule=" << cfg.rule << "\n";
+    out << "steps=" << cfg.steps << "\n";
+    return static_cast<bool>(out);
+}
+
+#endif
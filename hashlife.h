@@ -0,0 +1,402 @@
+#ifndef HASHLIFE_H
+#define HASHLIFE_H
+
+// ==================== HASHLIFE 1D (r = 1) ====================
+//
+// Evolution memoisee dans l'espace-temps (Gosper, adapte a une dimension).
+// L'etat est un arbre binaire de blocs alignes : un noeud de niveau k couvre
+// 2^k cellules, les feuilles (niveau 6) sont des mots de 64 cellules (cellule
+// i = bit i, comme PackedRing). Les noeuds sont partages (hash-consing) : deux
+// blocs identiques, ou qu'ils soient et a quelque generation que ce soit, sont
+// le meme noeud.
+//
+// Resultat d'un noeud de niveau k : ses 2^(k-1) cellules centrales apres
+// 2^(k-2) generations (le cone de dependance perd une cellule de chaque cote
+// par generation, il reste exactement la moitie centrale). Pour un noeud
+// (L, R) = (LL LR RL RR), avec q = 2^(k-2) :
+//   1. les trois noeuds de niveau k-1 L, (LR RL), R donnent leurs resultats
+//      a, b, c (q / 2 generations) ;
+//   2. les noeuds (a b) et (b c) donnent les deux moities du resultat
+//      (q / 2 generations de plus).
+// Le resultat est memorise dans le noeud : un motif regulier (Sierpinski de
+// la regle 90, trafic de la 184...) ne contient que peu de noeuds distincts et
+// la generation 10^12 s'obtient en quelques millisecondes. Pour un saut de
+// 2^j < 2^(k-2) generations, l'etape 1 prend les centres sans les avancer
+// (cache separe, cle (noeud, j)). Un saut de T generations enchaine les sauts
+// 2^j des bits de T.
+//
+// Deux univers :
+//   - ligne infinie sur fond de 0 (regles ou 000 -> 0) : la racine est
+//     agrandie de blocs vides tant que le motif n'est pas dans son quart
+//     central ;
+//   - anneau de 2^m cellules : pavage periodique, represente par le noeud
+//     (P P ... P) de niveau >= m + 2, partage lui aussi.
+//
+// Memoire bornee : au-dela de max_nodes noeuds, un ramasse-miettes (marquage
+// depuis la racine) libere les noeuds inaccessibles et les resultats qui y
+// menent, entre deux sauts. Si un saut depasse 2 x max_nodes en cours de
+// route, il est abandonne, la memoire est recuperee et le saut est refait en
+// deux moities ; une regle chaotique finit par ne plus tenir (l'etat lui-meme
+// depasse la borne) et advance() s'arrete en renvoyant false.
+//
+// La regle est lue via rule_to_binary (meme convention que evolve()).
+
+#include "achash.h"
+#include "cellular_automaton.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Hashlife1D {
+public:
+    typedef uint32_t NodeId;
+    static constexpr NodeId NONE = 0xFFFFFFFFu;
+    static constexpr int LEAF_LEVEL = 6;
+
+private:
+    static constexpr uint8_t FREE = 0xFF;
+    static constexpr uint64_t MAX_RETRY_JUMPS = 1024;   // sauts restants toleres apres un depassement
+
+    struct Node {
+        NodeId left = NONE, right = NONE;
+        NodeId result = NONE;     // moitie centrale apres 2^(level-2) generations
+        uint64_t leaf = 0;        // cellules d'une feuille
+        uint64_t population = 0;
+        uint8_t level = FREE;
+        bool marked = false;
+    };
+
+    uint64_t masks[8];
+    bool quiescent;               // regle(000) = 0 : fond de 0 stable
+
+    std::vector<Node> nodes;
+    std::vector<NodeId> free_list;
+    std::unordered_map<uint64_t, NodeId> leaves;      // valeur -> feuille
+    std::unordered_map<uint64_t, NodeId> internals;   // (gauche, droite) -> noeud
+    std::unordered_map<uint64_t, NodeId> step_cache;  // (noeud, j) -> resultat a 2^j generations
+    std::vector<NodeId> empties;                      // bloc vide par niveau
+    size_t max_nodes;
+    size_t collections_ = 0;
+    bool overflow = false;        // saut en cours abandonne (2 x max_nodes atteint)
+
+    // Univers
+    bool periodic = false;
+    NodeId root = NONE;           // ligne infinie : racine ; anneau : l'anneau (niveau ring_level)
+    long long origin_ = 0;        // ligne infinie : position de la cellule 0 de la racine
+    int ring_level = 0;
+    uint64_t generation_ = 0;
+
+    NodeId allocate(const Node &n) {
+        if (node_count() >= 2 * max_nodes) overflow = true;
+        if (!free_list.empty()) {
+            NodeId id = free_list.back();
+            free_list.pop_back();
+            nodes[id] = n;
+            return id;
+        }
+        nodes.push_back(n);
+        return static_cast<NodeId>(nodes.size() - 1);
+    }
+
+    static uint64_t pair_key(NodeId a, NodeId b) { return (static_cast<uint64_t>(a) << 32) | b; }
+
+    NodeId leaf(uint64_t cells) {
+        auto it = leaves.find(cells);
+        if (it != leaves.end()) return it->second;
+        Node n;
+        n.leaf = cells;
+        n.population = __builtin_popcountll(cells);
+        n.level = LEAF_LEVEL;
+        NodeId id = allocate(n);
+        leaves.emplace(cells, id);
+        return id;
+    }
+
+    NodeId join(NodeId a, NodeId b) {
+        auto it = internals.find(pair_key(a, b));
+        if (it != internals.end()) return it->second;
+        Node n;
+        n.left = a;
+        n.right = b;
+        n.population = nodes[a].population + nodes[b].population;
+        n.level = static_cast<uint8_t>(nodes[a].level + 1);
+        NodeId id = allocate(n);
+        internals.emplace(pair_key(a, b), id);
+        return id;
+    }
+
+    NodeId empty(int level) {
+        while (static_cast<int>(empties.size()) <= level) {
+            int l = static_cast<int>(empties.size());
+            if (l < LEAF_LEVEL) empties.push_back(NONE);
+            else if (l == LEAF_LEVEL) empties.push_back(leaf(0));
+            else empties.push_back(join(empties[l - 1], empties[l - 1]));
+        }
+        return empties[level];
+    }
+
+    // Moitie centrale d'un noeud de niveau >= 7, sans avancer dans le temps
+    NodeId center(NodeId id) {
+        const Node &n = nodes[id];
+        if (n.level == LEAF_LEVEL + 1)
+            return leaf((nodes[n.left].leaf >> 32) | (nodes[n.right].leaf << 32));
+        NodeId a = nodes[n.left].right, b = nodes[n.right].left;
+        return join(a, b);
+    }
+
+    // Niveau 7 : 128 cellules simulees directement, 64 cellules centrales
+    NodeId base_advance(NodeId id, int j) {
+        uint64_t lo = nodes[nodes[id].left].leaf, hi = nodes[nodes[id].right].leaf;
+        for (int s = 0; s < (1 << j); ++s) {
+            uint64_t xl[3] = {lo << 1, lo, (lo >> 1) | (hi << 63)};
+            uint64_t xh[3] = {(hi << 1) | (lo >> 63), hi, hi >> 1};
+            lo = ca_circuit<3>(masks, xl);
+            hi = ca_circuit<3>(masks, xh);
+        }
+        return leaf((lo >> 32) | (hi << 32));
+    }
+
+    // Moitie centrale du noeud 'id' (niveau k >= 7) apres 2^j generations, j <= k - 2
+    NodeId advance(NodeId id, int j) {
+        int k = nodes[id].level;
+        bool full = (j == k - 2);
+        if (overflow) return NONE;
+        if (full && nodes[id].result != NONE) return nodes[id].result;
+        if (quiescent && nodes[id].population == 0) return empty(k - 1);
+        uint64_t key = pair_key(id, static_cast<NodeId>(j));
+        if (!full) {
+            auto it = step_cache.find(key);
+            if (it != step_cache.end()) return it->second;
+        }
+
+        NodeId res;
+        if (k == LEAF_LEVEL + 1) {
+            res = base_advance(id, j);
+        } else {
+            NodeId l = nodes[id].left, r = nodes[id].right;
+            NodeId mid = center(id);
+            NodeId a, b, c;
+            if (full) {
+                a = advance(l, j - 1);
+                b = advance(mid, j - 1);
+                c = advance(r, j - 1);
+                if (overflow) return NONE;
+            } else {
+                a = center(l);
+                b = center(mid);
+                c = center(r);
+            }
+            int sub = full ? j - 1 : j;
+            NodeId ab = join(a, b);
+            NodeId bc = join(b, c);
+            NodeId left_half = advance(ab, sub);
+            NodeId right_half = advance(bc, sub);
+            if (overflow) return NONE;
+            res = join(left_half, right_half);
+        }
+        if (full) nodes[id].result = res;
+        else step_cache.emplace(key, res);
+        return res;
+    }
+
+    // Noeud couvrant words (2^m cellules, m >= 6)
+    NodeId build(const uint64_t *words, size_t count) {
+        if (count == 1) return leaf(words[0]);
+        NodeId a = build(words, count / 2);
+        NodeId b = build(words + count / 2, count / 2);
+        return join(a, b);
+    }
+
+    void flatten(NodeId id, uint64_t *out) const {
+        const Node &n = nodes[id];
+        if (n.level == LEAF_LEVEL) {
+            out[0] = n.leaf;
+            return;
+        }
+        flatten(n.left, out);
+        flatten(n.right, out + (size_t(1) << (n.level - 1 - LEAF_LEVEL)));
+    }
+
+    bool cell_in(NodeId id, uint64_t i) const {
+        while (nodes[id].level > LEAF_LEVEL) {
+            uint64_t half = uint64_t(1) << (nodes[id].level - 1);
+            if (i < half) {
+                id = nodes[id].left;
+            } else {
+                id = nodes[id].right;
+                i -= half;
+            }
+        }
+        return (nodes[id].leaf >> i) & 1;
+    }
+
+    // Motif contenu dans le quart central de la racine ? (racine de niveau >= 9)
+    bool centered() const {
+        const Node &n = nodes[root];
+        const Node &l = nodes[n.left], &r = nodes[n.right];
+        if (nodes[l.left].population != 0 || nodes[r.right].population != 0) return false;
+        return nodes[nodes[l.right].left].population == 0 && nodes[nodes[r.left].right].population == 0;
+    }
+
+    void expand() {
+        int k = nodes[root].level;
+        NodeId e = empty(k - 1);
+        NodeId l = nodes[root].left, r = nodes[root].right;
+        root = join(join(e, l), join(r, e));
+        origin_ -= static_cast<long long>(1) << (k - 1);
+    }
+
+    bool step_infinite(int j) {
+        while (nodes[root].level < std::max(j + 3, 9) || !centered()) expand();
+        int k = nodes[root].level;
+        NodeId res = advance(root, j);
+        if (res == NONE) return false;
+        root = res;
+        origin_ += static_cast<long long>(1) << (k - 2);
+        return true;
+    }
+
+    bool step_periodic(int j) {
+        // Pavage (P P ... P) de niveau L : sa moitie centrale commence a 2^(L-2),
+        // multiple de la periode des que L >= m + 2
+        int level = std::max(j + 2, ring_level + 2);
+        NodeId tiling = root;
+        for (int l = ring_level; l < level; ++l) tiling = join(tiling, tiling);
+        NodeId res = advance(tiling, j);
+        if (res == NONE) return false;
+        while (nodes[res].level > ring_level) res = nodes[res].left;
+        root = res;
+        return true;
+    }
+
+    // Marquage depuis la racine et les blocs vides, puis liberation du reste
+    void collect() {
+        std::vector<NodeId> stack(empties.begin(), empties.end());
+        stack.push_back(root);
+        while (!stack.empty()) {
+            NodeId id = stack.back();
+            stack.pop_back();
+            if (id == NONE || nodes[id].marked) continue;
+            nodes[id].marked = true;
+            if (nodes[id].level > LEAF_LEVEL) {
+                stack.push_back(nodes[id].left);
+                stack.push_back(nodes[id].right);
+            }
+        }
+        for (NodeId id = 0; id < nodes.size(); ++id) {
+            Node &n = nodes[id];
+            if (n.level == FREE) continue;
+            if (n.marked) {
+                if (n.result != NONE && !nodes[n.result].marked) n.result = NONE;
+                continue;
+            }
+            if (n.level == LEAF_LEVEL) leaves.erase(n.leaf);
+            else internals.erase(pair_key(n.left, n.right));
+            n.level = FREE;
+            free_list.push_back(id);
+        }
+        for (auto it = step_cache.begin(); it != step_cache.end();) {
+            if (!nodes[it->first >> 32].marked || !nodes[it->second].marked) it = step_cache.erase(it);
+            else ++it;
+        }
+        for (Node &n : nodes) n.marked = false;
+        collections_++;
+    }
+
+public:
+    explicit Hashlife1D(int rule, size_t max_nodes = size_t(1) << 21) : max_nodes(max_nodes) {
+        std::vector<int> rule_bits = rule_to_binary(rule);
+        for (int p = 0; p < 8; ++p) masks[p] = rule_bits[7 - p] ? ~0ULL : 0;
+        quiescent = (rule_bits[7] == 0);
+        empty(LEAF_LEVEL + 1);
+    }
+
+    // Ligne infinie : 'cells' placees a partir de la position 'origin', 0 ailleurs.
+    // Faux si la regle ne laisse pas le fond de 0 stable (000 -> 1).
+    bool load_line(const PackedRing &cells, long long origin = 0) {
+        if (!quiescent) return false;
+        size_t words = 2;
+        while (words * 64 < cells.cells) words *= 2;
+        std::vector<uint64_t> padded(words, 0);
+        std::copy(cells.words.begin(), cells.words.end(), padded.begin());
+        if (!cells.words.empty()) padded[cells.words.size() - 1] &= cells.last_mask();
+        periodic = false;
+        root = build(padded.data(), words);
+        origin_ = origin;
+        generation_ = 0;
+        return true;
+    }
+
+    // Anneau de 2^m cellules (m >= 6). Faux si la taille n'est pas une puissance de 2.
+    bool load_ring(const PackedRing &ring) {
+        if (ring.cells < 64 || (ring.cells & (ring.cells - 1)) != 0) return false;
+        periodic = true;
+        ring_level = __builtin_ctzll(ring.cells);
+        root = build(ring.words.data(), ring.words.size());
+        origin_ = 0;
+        generation_ = 0;
+        return true;
+    }
+
+    // Avance de 'generations' (< 2^60) par sauts de 2^j, du plus grand au plus
+    // petit. Faux si, apres un depassement de la borne memoire, il faudrait
+    // plus de MAX_RETRY_JUMPS sauts plus courts : la memoisation ne paie plus
+    // (regle chaotique), mieux vaut le simulateur direct. generation() indique
+    // ou l'evolution s'est arretee.
+    bool advance(uint64_t generations) {
+        int limit = 59;
+        while (generations != 0) {
+            int j = std::min(limit, 63 - __builtin_clzll(generations));
+            bool done = periodic ? step_periodic(j) : step_infinite(j);
+            if (!done) {
+                overflow = false;
+                collect();
+                if (j == 0 || (generations >> (j - 1)) > MAX_RETRY_JUMPS) return false;
+                limit = j - 1;
+                continue;
+            }
+            generations -= uint64_t(1) << j;
+            generation_ += uint64_t(1) << j;
+            if (node_count() > max_nodes) collect();
+        }
+        return true;
+    }
+
+    bool cell(long long position) const {
+        if (periodic) {
+            uint64_t n = uint64_t(1) << ring_level;
+            return cell_in(root, static_cast<uint64_t>(position) & (n - 1));
+        }
+        long long offset = position - origin_;
+        if (offset < 0 || (nodes[root].level < 63 && offset >= (1LL << nodes[root].level))) return false;
+        return cell_in(root, static_cast<uint64_t>(offset));
+    }
+
+    // Cellules [first, first + count)
+    PackedRing window(long long first, size_t count) const {
+        PackedRing out(count);
+        for (size_t i = 0; i < count; ++i)
+            if (cell(first + static_cast<long long>(i))) out.set(i, true);
+        return out;
+    }
+
+    // Anneau complet (univers periodique)
+    PackedRing ring() const {
+        PackedRing out(size_t(1) << ring_level);
+        flatten(root, out.words.data());
+        return out;
+    }
+
+    uint64_t population() const { return nodes[root].population; }
+    uint64_t generation() const { return generation_; }
+    bool is_periodic() const { return periodic; }
+    int root_level() const { return nodes[root].level; }
+    long long origin() const { return origin_; }
+    size_t node_count() const { return nodes.size() - free_list.size(); }
+    size_t collections() const { return collections_; }
+    size_t memo_entries() const { return step_cache.size(); }
+};
+
+#endif
@@ -0,0 +1,305 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+// ==================== LOGGER ASYNCHRONE ====================
+//
+// Les boucles chaudes (minage, tests statistiques, simulation) ne doivent pas
+// attendre la console. Chaque thread producteur depose des enregistrements de
+// taille fixe (format + arguments types, sans mise en forme) dans son propre
+// anneau SPSC sans verrou ; un thread de fond les formate et les ecrit par
+// lots sur stdout. Si l'anneau est plein, l'enregistrement est compte comme
+// perdu au lieu de bloquer le producteur.
+//
+// Le format utilise des "{}" (ou "{:.Nf}" pour un flottant a N decimales).
+// log_flush() attend que les messages du thread courant soient ecrits : a
+// appeler avant de reprendre un affichage direct par cout.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+enum LogLevel { LOG_LEVEL_DEBUG, LOG_LEVEL_INFO, LOG_LEVEL_WARN, LOG_LEVEL_ERROR };
+
+const int LOG_MAX_ARGS = 6;
+const size_t LOG_INLINE_CHARS = 16;
+
+/**
+ * Argument d'un enregistrement. Les chaines courtes sont copiees sur place,
+ * les longues dans un tampon alloue libere par le consommateur.
+ */
+struct LogArg {
+    enum Type : uint8_t { I64, U64, F64, STR_INLINE, STR_HEAP } type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double f;
+        char inl[LOG_INLINE_CHARS];
+        char *heap;
+    };
+};
+
+struct LogRecord {
+    const char *fmt;   // litteral : duree de vie statique
+    uint8_t level;
+    uint8_t nargs;
+    LogArg args[LOG_MAX_ARGS];
+};
+
+// ---------------------------- Conversion des arguments ----------------------------
+
+inline void log_set_string(LogArg &a, const char *s, size_t n) {
+    if (n < LOG_INLINE_CHARS) {
+        a.type = LogArg::STR_INLINE;
+        memcpy(a.inl, s, n);
+        a.inl[n] = '\0';
+    } else {
+        a.type = LogArg::STR_HEAP;
+        a.heap = new char[n + 1];
+        memcpy(a.heap, s, n);
+        a.heap[n] = '\0';
+    }
+}
+
+template <typename T>
+inline void log_set_arg(LogArg &a, const T &v) {
+    if constexpr (std::is_floating_point<T>::value) {
+        a.type = LogArg::F64;
+        a.f = static_cast<double>(v);
+    } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+        a.type = LogArg::I64;
+        a.i = static_cast<int64_t>(v);
+    } else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value) {
+        a.type = LogArg::U64;
+        a.u = static_cast<uint64_t>(v);
+    } else if constexpr (std::is_convertible<T, std::string>::value &&
+                         !std::is_pointer<typename std::decay<T>::type>::value &&
+                         !std::is_array<T>::value) {
+        const std::string &s = v;
+        log_set_string(a, s.data(), s.size());
+    } else {
+        const char *s = v;
+        log_set_string(a, s, strlen(s));
+    }
+}
+
+inline void log_release(LogRecord &rec) {
+    for (int i = 0; i < rec.nargs; i++)
+        if (rec.args[i].type == LogArg::STR_HEAP) delete[] rec.args[i].heap;
+}
+
+// Mise en forme cote consommateur
+inline void log_format(const LogRecord &rec, std::string &out) {
+    static const char *const LEVEL_PREFIX[] = {"[debug] ", "", "[warn] ", "[erreur] "};
+    out += LEVEL_PREFIX[rec.level];
+
+    char num[64];
+    int argIndex = 0;
+    for (const char *p = rec.fmt; *p; ++p) {
+        if (*p != '{') {
+            out += *p;
+            continue;
+        }
+        const char *close = strchr(p, '}');
+        if (!close || argIndex >= rec.nargs) {
+            out += *p;
+            continue;
+        }
+        int precision = -1;
+        if (p[1] == ':' && p[2] == '.') precision = atoi(p + 3);
+
+        const LogArg &a = rec.args[argIndex++];
+        switch (a.type) {
+            case LogArg::I64: snprintf(num, sizeof(num), "%lld", (long long)a.i); out += num; break;
+            case LogArg::U64: snprintf(num, sizeof(num), "%llu", (unsigned long long)a.u); out += num; break;
+            case LogArg::F64:
+                if (precision >= 0) snprintf(num, sizeof(num), "%.*f", precision, a.f);
+                else snprintf(num, sizeof(num), "%g", a.f);
+                out += num;
+                break;
+            case LogArg::STR_INLINE: out += a.inl; break;
+            case LogArg::STR_HEAP: out += a.heap; break;
+        }
+        p = close;
+    }
+    out += '\n';
+}
+
+// ---------------------------- Anneau SPSC ----------------------------
+
+/**
+ * Anneau a un producteur (le thread proprietaire) et un consommateur (le
+ * thread d'ecriture). head/tail sur des lignes de cache separees.
+ */
+struct LogRing {
+    static const size_t CAPACITY = 1024; // puissance de 2
+
+    alignas(64) std::atomic<size_t> head{0};    // ecrit par le producteur
+    alignas(64) std::atomic<size_t> tail{0};    // ecrit par le consommateur
+    std::atomic<size_t> written{0};             // enregistrements effectivement ecrits
+    alignas(64) std::atomic<uint64_t> dropped{0};
+    uint64_t droppedReported = 0;               // consommateur uniquement
+    LogRecord records[CAPACITY];
+
+    bool push(const LogRecord &rec) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == CAPACITY) return false;
+        records[h & (CAPACITY - 1)] = rec;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(LogRecord &rec) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        rec = records[t & (CAPACITY - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// ---------------------------- Logger ----------------------------
+
+class AsyncLogger {
+private:
+    std::mutex ringsLock;                       // seulement a l'enregistrement d'un thread
+    std::vector<std::unique_ptr<LogRing>> rings;
+    std::mutex wakeLock;
+    std::condition_variable wake;               // reveil du consommateur (flush)
+    std::condition_variable written;            // fin d'un lot ecrit
+    std::atomic<bool> running{true};
+    std::thread worker;
+    FILE *out;
+
+    static const size_t BATCH = 256;
+
+    // Vide tous les anneaux ; renvoie le nombre d'enregistrements ecrits
+    size_t drainAll() {
+        std::vector<LogRing *> snapshot;
+        {
+            std::lock_guard<std::mutex> guard(ringsLock);
+            for (const auto &r : rings) snapshot.push_back(r.get());
+        }
+
+        size_t total = 0;
+        std::string buffer;
+        LogRecord rec;
+        for (LogRing *ring : snapshot) {
+            size_t n = 0;
+            while (n < BATCH && ring->pop(rec)) {
+                log_format(rec, buffer);
+                log_release(rec);
+                n++;
+            }
+            uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+            if (dropped != ring->droppedReported) {
+                buffer += "[logger] " + std::to_string(dropped - ring->droppedReported) + " message(s) perdu(s)\n";
+                ring->droppedReported = dropped;
+            }
+            if (!buffer.empty()) {
+                fwrite(buffer.data(), 1, buffer.size(), out);
+                buffer.clear();
+            }
+            ring->written.store(ring->tail.load(std::memory_order_relaxed), std::memory_order_release);
+            total += n;
+        }
+        if (total > 0) fflush(out);
+        return total;
+    }
+
+    void run() {
+        while (running.load(std::memory_order_acquire)) {
+            size_t n = drainAll();
+            written.notify_all();
+            if (n == 0) {
+                std::unique_lock<std::mutex> lock(wakeLock);
+                wake.wait_for(lock, std::chrono::milliseconds(1));
+            }
+        }
+        while (drainAll() > 0) {}
+        written.notify_all();
+    }
+
+public:
+    explicit AsyncLogger(FILE *sink = stdout) : out(sink) {
+        worker = std::thread([this] { run(); });
+    }
+
+    ~AsyncLogger() {
+        running.store(false, std::memory_order_release);
+        wake.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    LogRing &localRing() {
+        thread_local LogRing *ring = nullptr;
+        if (!ring) {
+            std::lock_guard<std::mutex> guard(ringsLock);
+            rings.emplace_back(new LogRing());
+            ring = rings.back().get();
+        }
+        return *ring;
+    }
+
+    template <typename... Args>
+    void log(LogLevel level, const char *fmt, const Args &...args) {
+        static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "trop d'arguments pour un enregistrement");
+        LogRecord rec;
+        rec.fmt = fmt;
+        rec.level = static_cast<uint8_t>(level);
+        rec.nargs = static_cast<uint8_t>(sizeof...(Args));
+        int i = 0;
+        (log_set_arg(rec.args[i++], args), ...);
+
+        LogRing &ring = localRing();
+        if (!ring.push(rec)) {
+            log_release(rec);
+            ring.dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Attend que tout ce que le thread courant a deja depose soit ecrit
+     */
+    void flush() {
+        LogRing &ring = localRing();
+        size_t target = ring.head.load(std::memory_order_relaxed);
+        wake.notify_all();
+        std::unique_lock<std::mutex> lock(wakeLock);
+        written.wait_for(lock, std::chrono::seconds(5), [&] {
+            return ring.written.load(std::memory_order_acquire) >= target;
+        });
+    }
+
+    uint64_t droppedCount() {
+        uint64_t total = 0;
+        std::lock_guard<std::mutex> guard(ringsLock);
+        for (const auto &r : rings) total += r->dropped.load(std::memory_order_relaxed);
+        return total;
+    }
+};
+
+inline AsyncLogger &logger() {
+    static AsyncLogger instance;
+    return instance;
+}
+
+inline void log_flush() {
+    logger().flush();
+}
+
+#define LOG_DEBUG(...) logger().log(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)  logger().log(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_WARN(...)  logger().log(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_ERROR(...) logger().log(LOG_LEVEL_ERROR, __VA_ARGS__)
+
+#endif
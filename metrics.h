@@ -0,0 +1,256 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+// ==================== METRIQUES DES CHEMINS CHAUDS ====================
+//
+// Compteurs par thread (un par ligne de cache) et histogrammes de latence a
+// buckets logarithmiques (puissances de 2 en ns). Chaque thread n'ecrit que
+// dans ses propres compteurs ; les valeurs sont fusionnees a la demande.
+// Active avec -DAC_METRICS (make METRICS=1) : le JSON est ecrit a la sortie
+// du programme et sur SIGUSR1 dans $AC_METRICS_FILE (defaut: metrics.json).
+// Sans le flag, les macros METRIC_* ne generent aucun code.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(AC_METRICS) && defined(__unix__)
+#include <csignal>
+#include <pthread.h>
+#include <thread>
+#endif
+
+enum MetricCounter {
+    METRIC_HASH_AC_BASIC,
+    METRIC_HASH_AC,
+    METRIC_HASH_AC_PLUS,
+    METRIC_HASH_SHA256,
+    METRIC_MINING_ATTEMPTS,
+    METRIC_BLOCKS_MINED,
+    METRIC_COUNTER_COUNT
+};
+
+enum MetricHistogram {
+    METRIC_MINING_TIME,
+    METRIC_MERKLE_BUILD_TIME,
+    METRIC_BLOCK_VALIDATION_TIME,
+    METRIC_POS_SELECTION_TIME,
+    METRIC_HISTOGRAM_COUNT
+};
+
+static const char *const METRIC_COUNTER_NAMES[METRIC_COUNTER_COUNT] = {
+    "hashes.ac_hash_basic", "hashes.ac_hash", "hashes.ac_hash_plus", "hashes.sha256",
+    "mining.attempts", "mining.blocks"
+};
+
+static const char *const METRIC_HISTOGRAM_NAMES[METRIC_HISTOGRAM_COUNT] = {
+    "mining.time_ns", "merkle.build_time_ns", "block.validation_time_ns", "pos.selection_time_ns"
+};
+
+const int METRIC_BUCKETS = 64; // bucket b : [2^b, 2^(b+1)) ns
+
+/**
+ * Compteur seul sur sa ligne de cache : pas de faux partage entre threads.
+ * Un seul ecrivain (le thread proprietaire), donc pas d'instruction atomique
+ * verrouillee ; l'atomique relaxe sert uniquement a la lecture concurrente.
+ */
+struct alignas(64) PaddedCounter {
+    std::atomic<uint64_t> value{0};
+
+    void add(uint64_t n) { value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+struct alignas(64) LatencyHistogram {
+    PaddedCounter count;
+    PaddedCounter sumNs;
+    std::atomic<uint64_t> buckets[METRIC_BUCKETS];
+
+    LatencyHistogram() {
+        for (int b = 0; b < METRIC_BUCKETS; b++) buckets[b].store(0, std::memory_order_relaxed);
+    }
+
+    void record(uint64_t ns) {
+        int b = 63 - __builtin_clzll(ns | 1);
+        buckets[b].store(buckets[b].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        count.add(1);
+        sumNs.add(ns);
+    }
+};
+
+struct ThreadMetrics {
+    PaddedCounter counters[METRIC_COUNTER_COUNT];
+    LatencyHistogram histograms[METRIC_HISTOGRAM_COUNT];
+};
+
+/**
+ * Registre global : les blocs par thread ne sont jamais liberes, pour que
+ * les valeurs des threads termines restent dans les totaux.
+ */
+struct MetricsRegistry {
+    std::mutex lock;
+    std::vector<std::unique_ptr<ThreadMetrics>> threads;
+};
+
+inline MetricsRegistry &metrics_registry() {
+    static MetricsRegistry *registry = new MetricsRegistry(); // survit aux destructeurs statiques
+    return *registry;
+}
+
+inline ThreadMetrics &metrics_local() {
+    thread_local ThreadMetrics *local = nullptr;
+    if (!local) {
+        MetricsRegistry &registry = metrics_registry();
+        std::lock_guard<std::mutex> guard(registry.lock);
+        registry.threads.emplace_back(new ThreadMetrics());
+        local = registry.threads.back().get();
+    }
+    return *local;
+}
+
+struct MetricsSnapshot {
+    uint64_t counters[METRIC_COUNTER_COUNT] = {};
+    uint64_t histCount[METRIC_HISTOGRAM_COUNT] = {};
+    uint64_t histSumNs[METRIC_HISTOGRAM_COUNT] = {};
+    uint64_t buckets[METRIC_HISTOGRAM_COUNT][METRIC_BUCKETS] = {};
+};
+
+/**
+ * Fusionne les compteurs de tous les threads
+ */
+inline MetricsSnapshot metrics_snapshot() {
+    MetricsSnapshot snap;
+    MetricsRegistry &registry = metrics_registry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    for (const auto &t : registry.threads) {
+        for (int c = 0; c < METRIC_COUNTER_COUNT; c++)
+            snap.counters[c] += t->counters[c].get();
+        for (int h = 0; h < METRIC_HISTOGRAM_COUNT; h++) {
+            const LatencyHistogram &hist = t->histograms[h];
+            snap.histCount[h] += hist.count.get();
+            snap.histSumNs[h] += hist.sumNs.get();
+            for (int b = 0; b < METRIC_BUCKETS; b++)
+                snap.buckets[h][b] += hist.buckets[b].load(std::memory_order_relaxed);
+        }
+    }
+    return snap;
+}
+
+// Percentile approche : borne superieure du bucket qui contient le rang
+inline uint64_t metrics_percentile(const MetricsSnapshot &snap, int h, double p) {
+    uint64_t total = snap.histCount[h];
+    if (total == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(p * total);
+    uint64_t seen = 0;
+    for (int b = 0; b < METRIC_BUCKETS; b++) {
+        seen += snap.buckets[h][b];
+        if (seen > rank) return (b >= 63) ? UINT64_MAX : ((uint64_t)2 << b);
+    }
+    return UINT64_MAX;
+}
+
+inline std::string metrics_file_path() {
+    const char *path = getenv("AC_METRICS_FILE");
+    return (path && *path) ? path : "metrics.json";
+}
+
+/**
+ * Ecrit l'etat fusionne en JSON (remplacement atomique du fichier)
+ */
+inline bool metrics_dump_json(const std::string &path) {
+    MetricsSnapshot snap = metrics_snapshot();
+    std::string tmp = path + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "w");
+    if (!f) return false;
+
+    long long now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    fprintf(f, "{\n  \"timestamp_ms\": %lld,\n  \"counters\": {\n", now);
+    for (int c = 0; c < METRIC_COUNTER_COUNT; c++)
+        fprintf(f, "    \"%s\": %llu%s\n", METRIC_COUNTER_NAMES[c],
+                (unsigned long long)snap.counters[c], c + 1 < METRIC_COUNTER_COUNT ? "," : "");
+
+    double miningSeconds = snap.histSumNs[METRIC_MINING_TIME] / 1e9;
+    double hashrate = miningSeconds > 0 ? snap.counters[METRIC_MINING_ATTEMPTS] / miningSeconds : 0.0;
+    fprintf(f, "  },\n  \"mining.hashrate_per_s\": %.3f,\n  \"histograms\": {\n", hashrate);
+
+    for (int h = 0; h < METRIC_HISTOGRAM_COUNT; h++) {
+        uint64_t count = snap.histCount[h];
+        fprintf(f, "    \"%s\": {\"count\": %llu, \"sum\": %llu, \"mean\": %.1f, \"p50\": %llu, \"p99\": %llu, \"buckets\": {",
+                METRIC_HISTOGRAM_NAMES[h], (unsigned long long)count,
+                (unsigned long long)snap.histSumNs[h], count ? (double)snap.histSumNs[h] / count : 0.0,
+                (unsigned long long)metrics_percentile(snap, h, 0.50),
+                (unsigned long long)metrics_percentile(snap, h, 0.99));
+        bool first = true;
+        for (int b = 0; b < METRIC_BUCKETS; b++) {
+            if (snap.buckets[h][b] == 0) continue;
+            fprintf(f, "%s\"%llu\": %llu", first ? "" : ", ",
+                    (unsigned long long)((uint64_t)1 << b), (unsigned long long)snap.buckets[h][b]);
+            first = false;
+        }
+        fprintf(f, "}}%s\n", h + 1 < METRIC_HISTOGRAM_COUNT ? "," : "");
+    }
+    fprintf(f, "  }\n}\n");
+    fclose(f);
+    return rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * Chronometre RAII qui alimente un histogramme
+ */
+class MetricTimer {
+private:
+    MetricHistogram hist;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit MetricTimer(MetricHistogram h) : hist(h), start(std::chrono::steady_clock::now()) {}
+    ~MetricTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        metrics_local().histograms[hist].record(static_cast<uint64_t>(ns));
+    }
+};
+
+#ifdef AC_METRICS
+
+/**
+ * Installe l'export : a la sortie (atexit) et sur SIGUSR1. Le signal est
+ * bloque puis attendu par un thread dedie (sigwait), l'ecriture du fichier
+ * ne se fait donc jamais dans un gestionnaire de signal.
+ */
+struct MetricsExporter {
+    MetricsExporter() {
+        atexit([] { metrics_dump_json(metrics_file_path()); });
+#if defined(__unix__)
+        sigset_t set;
+        sigemptyset(&set);
+        sigaddset(&set, SIGUSR1);
+        pthread_sigmask(SIG_BLOCK, &set, nullptr);
+        std::thread([set]() {
+            int sig;
+            while (sigwait(&set, &sig) == 0)
+                metrics_dump_json(metrics_file_path());
+        }).detach();
+#endif
+    }
+};
+
+inline MetricsExporter metrics_exporter;
+
+#define METRIC_ADD(counter, n) metrics_local().counters[counter].add(n)
+#define METRIC_TIME(var, hist) MetricTimer var(hist)
+#define METRIC_RECORD(hist, ns) metrics_local().histograms[hist].record(ns)
+#else
+#define METRIC_ADD(counter, n) ((void)0)
+#define METRIC_TIME(var, hist) ((void)0)
+#define METRIC_RECORD(hist, ns) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,236 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <iomanip>
+#include "achash.h"
+#include "nist_tests.h"
+#include "trace.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// ==================== BATTERIE STATISTIQUE EN FLUX (AC_HASH) ====================
+//
+// La sequence testee est la concatenation des empreintes de messages
+// compteurs (graine || i, 16 octets). Elle est produite par paquets de
+// 1 Mbit dans un anneau de quelques emplacements (memoire constante) ; les
+// 8 tests lisent chacun chaque paquet dans leur propre thread, en parallele.
+
+const size_t CHUNK_DIGESTS = 4096;                 // 4096 x 256 bits = 1 Mbit
+const size_t CHUNK_WORDS = CHUNK_DIGESTS * 4;
+const size_t RING_SLOTS = 4;
+
+struct BatteryConfig {
+    string variant = "ac";           // ac | plus | basic
+    size_t megabits = 8;
+    vector<uint32_t> rules = {30, 90, 110};
+    vector<size_t> steps = {1, 3, 10};
+    unsigned producers = 0;          // 0 : tous les coeurs
+    uint64_t seed = 2024;
+};
+
+/**
+ * Anneau de diffusion : un paquet est ecrit une fois par un producteur et lu
+ * par tous les consommateurs. Etat d'un emplacement :
+ *   FREE (paquet 'chunk' lu par tous, ou aucun) -> FILLING -> PUBLISHED -> FREE
+ * Le paquet c + RING_SLOTS ne le reprend que FREE apres le paquet c : jamais
+ * pendant le remplissage ni avant la derniere lecture.
+ */
+class BroadcastRing {
+private:
+    enum class SlotState { FREE, FILLING, PUBLISHED };
+    struct Slot {
+        vector<uint64_t> words;
+        long long chunk = -1;
+        SlotState state = SlotState::FREE;
+        int readers = 0;
+    };
+    Slot slots[RING_SLOTS];
+    int consumers;
+    mutex lock;
+    condition_variable changed;
+
+public:
+    explicit BroadcastRing(int c) : consumers(c) {
+        for (Slot &s : slots) s.words.resize(CHUNK_WORDS);
+    }
+
+    // Reserve l'emplacement du paquet c (attend la fin des lectures de c - RING_SLOTS)
+    vector<uint64_t> &acquire(long long c) {
+        Slot &s = slots[c % RING_SLOTS];
+        long long previous = (c >= (long long)RING_SLOTS) ? c - (long long)RING_SLOTS : -1;
+        unique_lock<mutex> guard(lock);
+        changed.wait(guard, [&] { return s.chunk == previous && s.state == SlotState::FREE; });
+        s.chunk = c;
+        s.state = SlotState::FILLING;
+        return s.words;
+    }
+
+    void publish(long long c) {
+        Slot &s = slots[c % RING_SLOTS];
+        {
+            lock_guard<mutex> guard(lock);
+            s.state = SlotState::PUBLISHED;
+            s.readers = consumers;
+        }
+        changed.notify_all();
+    }
+
+    const vector<uint64_t> &read(long long c) {
+        Slot &s = slots[c % RING_SLOTS];
+        unique_lock<mutex> guard(lock);
+        changed.wait(guard, [&] { return s.chunk == c && s.state == SlotState::PUBLISHED; });
+        return s.words;
+    }
+
+    void release(long long c) {
+        Slot &s = slots[c % RING_SLOTS];
+        bool last;
+        {
+            lock_guard<mutex> guard(lock);
+            last = (--s.readers == 0);
+            if (last) s.state = SlotState::FREE;
+        }
+        if (last) changed.notify_all();
+    }
+};
+
+// Paquet c : empreintes des messages (graine || index) en big-endian
+static void generate_chunk(const BatteryConfig &cfg, uint32_t rule, size_t steps, long long c,
+                           vector<string> &messages, vector<Digest256> &digests, vector<uint64_t> &out) {
+    for (size_t i = 0; i < CHUNK_DIGESTS; i++) {
+        uint64_t index = (uint64_t)c * CHUNK_DIGESTS + i;
+        string &m = messages[i];
+        m.resize(16);
+        for (int b = 0; b < 8; b++) {
+            m[b] = static_cast<char>(cfg.seed >> (56 - 8 * b));
+            m[8 + b] = static_cast<char>(index >> (56 - 8 * b));
+        }
+    }
+    if (cfg.variant == "plus") {
+        ac_hash_plus_digest_batch(messages.data(), CHUNK_DIGESTS, rule, steps, digests.data());
+    } else if (cfg.variant == "basic") {
+        for (size_t i = 0; i < CHUNK_DIGESTS; i++) digests[i] = ac_hash_basic_digest(messages[i], rule, steps);
+    } else {
+        ac_hash_digest_batch(messages.data(), CHUNK_DIGESTS, rule, steps, digests.data());
+    }
+    for (size_t i = 0; i < CHUNK_DIGESTS; i++)
+        for (int w = 0; w < 4; w++) out[4 * i + w] = digests[i][w];
+}
+
+static vector<NistPValue> run_battery(const BatteryConfig &cfg, uint32_t rule, size_t steps) {
+    TRACE_SCOPE_ARG("run_battery", "rule", rule);
+    uint64_t n = (uint64_t)cfg.megabits * CHUNK_WORDS * 64;
+    vector<unique_ptr<StreamTest>> tests;
+    tests.emplace_back(new FrequencyTest());
+    tests.emplace_back(new BlockFrequencyTest(n));
+    tests.emplace_back(new RunsTest());
+    tests.emplace_back(new LongestRunTest(n));
+    tests.emplace_back(new SerialTest(n));
+    tests.emplace_back(new ApproximateEntropyTest(n));
+    tests.emplace_back(new CumulativeSumsTest());
+    tests.emplace_back(new RankTest());
+
+    BroadcastRing ring(static_cast<int>(tests.size()));
+    long long chunks = static_cast<long long>(cfg.megabits);
+    atomic<long long> nextChunk{0};
+
+    unsigned producers = cfg.producers ? cfg.producers : thread::hardware_concurrency();
+    if (producers == 0) producers = 1;
+
+    vector<thread> threads;
+    for (unsigned p = 0; p < producers; p++) {
+        threads.emplace_back([&] {
+            vector<string> messages(CHUNK_DIGESTS);
+            vector<Digest256> digests(CHUNK_DIGESTS);
+            for (;;) {
+                long long c = nextChunk.fetch_add(1);
+                if (c >= chunks) break;
+                vector<uint64_t> &out = ring.acquire(c);
+                generate_chunk(cfg, rule, steps, c, messages, digests, out);
+                ring.publish(c);
+            }
+        });
+    }
+    for (auto &test : tests) {
+        StreamTest *t = test.get();
+        threads.emplace_back([&ring, t, chunks] {
+            for (long long c = 0; c < chunks; c++) {
+                const vector<uint64_t> &words = ring.read(c);
+                t->consume(words.data(), words.size());
+                ring.release(c);
+            }
+            t->finish();
+        });
+    }
+    for (thread &th : threads) th.join();
+
+    vector<NistPValue> results;
+    for (auto &test : tests)
+        for (const NistPValue &p : test->pValues()) results.push_back(p);
+    return results;
+}
+
+template <typename T>
+static vector<T> parse_list(const string &s) {
+    vector<T> out;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty()) out.push_back(static_cast<T>(stoul(item)));
+    return out;
+}
+
+// Usage : nist_battery [ac|plus|basic] [megabits] [regles ex: 30,90,110] [etapes ex: 1,3,10] [producteurs] [graine]
+int main(int argc, char **argv) {
+    BatteryConfig cfg;
+    if (argc > 1) cfg.variant = argv[1];
+    if (argc > 2) cfg.megabits = stoul(argv[2]);
+    if (argc > 3) cfg.rules = parse_list<uint32_t>(argv[3]);
+    if (argc > 4) cfg.steps = parse_list<size_t>(argv[4]);
+    if (argc > 5) cfg.producers = static_cast<unsigned>(stoul(argv[5]));
+    if (argc > 6) cfg.seed = stoull(argv[6]);
+
+    if ((cfg.variant != "ac" && cfg.variant != "plus" && cfg.variant != "basic") || cfg.megabits == 0) {
+        cerr << "Usage: nist_battery [ac|plus|basic] [megabits>0] [regles] [etapes] [producteurs] [graine]" << endl;
+        return 1;
+    }
+
+    cout << "==============================================" << endl;
+    cout << "BATTERIE STATISTIQUE (NIST SP 800-22) - " << cfg.variant << endl;
+    cout << "==============================================" << endl;
+    cout << "Sequence: " << cfg.megabits << " Mbit par configuration, graine " << cfg.seed << endl;
+    cout << "Seuil: p-value >= 0.01" << endl << endl;
+
+    bool header = false;
+    for (uint32_t rule : cfg.rules) {
+        for (size_t steps : cfg.steps) {
+            auto start = steady_clock::now();
+            vector<NistPValue> results = run_battery(cfg, rule, steps);
+            double seconds = duration<double>(steady_clock::now() - start).count();
+
+            if (!header) {
+                cout << left << setw(7) << "Regle" << setw(7) << "Etapes";
+                for (const NistPValue &p : results) cout << right << setw(21) << p.label;
+                cout << right << setw(8) << "Echecs" << setw(10) << "Mbit/s" << endl;
+                header = true;
+            }
+            int failures = 0;
+            cout << left << setw(7) << rule << setw(7) << steps << right << fixed << setprecision(4);
+            for (const NistPValue &p : results) {
+                if (p.p < 0.01) failures++;
+                cout << setw(20) << p.p << (p.p < 0.01 ? "*" : " ");
+            }
+            cout << setw(8) << failures << setw(10) << setprecision(1) << cfg.megabits * 1.048576 / seconds << endl;
+        }
+    }
+    cout << "\n* : p-value < 0.01 (test echoue)" << endl;
+    return 0;
+}
@@ -0,0 +1,402 @@
+#ifndef NIST_TESTS_H
+#define NIST_TESTS_H
+
+// ==================== BATTERIE NIST SP 800-22 (EN FLUX) ====================
+//
+// Versions en flux des tests de NIST SP 800-22 : chaque test consomme la
+// sequence par paquets de mots de 64 bits (bit de poids fort en premier) et
+// garde un etat de taille constante ; pValues() conclut a la fin.
+// La longueur totale n (en bits, multiple de 64) est connue a la construction
+// pour choisir les parametres (taille de bloc, m) comme le recommande NIST.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "digest_stats.h"
+
+struct NistPValue {
+    std::string label;
+    double p;
+};
+
+class StreamTest {
+public:
+    virtual ~StreamTest() {}
+    virtual void consume(const uint64_t *words, size_t count) = 0;
+    virtual void finish() {}   // fin de sequence, avant pValues()
+    virtual std::vector<NistPValue> pValues() const = 0;
+};
+
+inline double normal_cdf(double x) {
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+// ---------------------------- 1. Frequence (monobit) ----------------------------
+
+class FrequencyTest : public StreamTest {
+private:
+    uint64_t ones = 0, bits = 0;
+
+public:
+    void consume(const uint64_t *w, size_t count) override {
+        for (size_t i = 0; i < count; i++) ones += __builtin_popcountll(w[i]);
+        bits += 64 * count;
+    }
+
+    std::vector<NistPValue> pValues() const override {
+        double s = 2.0 * ones - (double)bits;
+        return {{"frequency", std::erfc(std::fabs(s) / std::sqrt((double)bits) / std::sqrt(2.0))}};
+    }
+};
+
+// ---------------------------- 2. Frequence par bloc ----------------------------
+
+/**
+ * Blocs de M bits (multiple de 64, M > n / 100 pour garder N < 100 blocs)
+ */
+class BlockFrequencyTest : public StreamTest {
+private:
+    uint64_t blockWords;
+    uint64_t wordsInBlock = 0, onesInBlock = 0, blocks = 0;
+    double sum = 0;   // somme (pi_i - 1/2)^2
+
+public:
+    explicit BlockFrequencyTest(uint64_t n) {
+        uint64_t m = std::max<uint64_t>(128, n / 99 + 1);
+        blockWords = (m + 63) / 64;
+    }
+
+    void consume(const uint64_t *w, size_t count) override {
+        for (size_t i = 0; i < count; i++) {
+            onesInBlock += __builtin_popcountll(w[i]);
+            if (++wordsInBlock == blockWords) {
+                double pi = (double)onesInBlock / (64.0 * blockWords);
+                sum += (pi - 0.5) * (pi - 0.5);
+                blocks++;
+                wordsInBlock = onesInBlock = 0;
+            }
+        }
+    }
+
+    std::vector<NistPValue> pValues() const override {
+        double chi2 = 4.0 * 64.0 * blockWords * sum;
+        return {{"block_frequency", blocks ? gamma_q(blocks / 2.0, chi2 / 2.0) : 0.0}};
+    }
+};
+
+// ---------------------------- 3. Runs ----------------------------
+
+class RunsTest : public StreamTest {
+private:
+    uint64_t ones = 0, bits = 0, transitions = 0;
+    uint64_t lastBit = 0;
+
+public:
+    void consume(const uint64_t *w, size_t count) override {
+        for (size_t i = 0; i < count; i++) {
+            // Bit k compare a son predecesseur dans la sequence
+            uint64_t shifted = (w[i] >> 1) | (lastBit << 63);
+            uint64_t diff = w[i] ^ shifted;
+            if (bits == 0) diff &= ~(1ULL << 63);   // pas de predecesseur
+            transitions += __builtin_popcountll(diff);
+            ones += __builtin_popcountll(w[i]);
+            lastBit = w[i] & 1;
+            bits += 64;
+        }
+    }
+
+    std::vector<NistPValue> pValues() const override {
+        double n = (double)bits, pi = ones / n;
+        if (std::fabs(pi - 0.5) >= 2.0 / std::sqrt(n)) return {{"runs", 0.0}}; // prerequis monobit
+        double v = transitions + 1.0;
+        double p = std::erfc(std::fabs(v - 2 * n * pi * (1 - pi)) / (2 * std::sqrt(2 * n) * pi * (1 - pi)));
+        return {{"runs", p}};
+    }
+};
+
+// ---------------------------- 4. Plus longue suite de 1 ----------------------------
+
+/**
+ * M = 10000 (K = 6) si n >= 750000, sinon M = 128 (K = 5)
+ */
+class LongestRunTest : public StreamTest {
+private:
+    uint64_t blockBits;
+    int minRun, categories;
+    std::vector<double> probabilities;
+    std::vector<uint64_t> counts;
+    uint64_t bitsInBlock = 0, current = 0, longest = 0;
+
+    void closeBlock() {
+        int c = (int)std::min<uint64_t>(std::max<uint64_t>(longest, (uint64_t)minRun), (uint64_t)(minRun + categories - 1)) - minRun;
+        counts[c]++;
+        bitsInBlock = current = longest = 0;
+    }
+
+public:
+    explicit LongestRunTest(uint64_t n) {
+        if (n >= 750000) {
+            blockBits = 10000;
+            minRun = 10;
+            probabilities = {0.0882, 0.2092, 0.2483, 0.1933, 0.1208, 0.0675, 0.0727};
+        } else {
+            blockBits = 128;
+            minRun = 4;
+            probabilities = {0.1174, 0.2430, 0.2493, 0.1752, 0.1027, 0.1124};
+        }
+        categories = (int)probabilities.size();
+        counts.assign(categories, 0);
+    }
+
+    void consume(const uint64_t *w, size_t count) override {
+        for (size_t i = 0; i < count; i++) {
+            uint64_t x = w[i];
+            int remaining = 64;
+            while (remaining > 0) {
+                // Segment : 'take' bits en tete de x, jusqu'a la fin du bloc courant
+                int take = (int)std::min<uint64_t>(remaining, blockBits - bitsInBlock);
+                uint64_t seg = (take == 64) ? x : x & ~(~0ULL >> take);
+                int lead = (~seg == 0) ? 64 : __builtin_clzll(~seg);
+                if (lead >= take) {
+                    current += take;
+                    longest = std::max(longest, current);
+                } else {
+                    longest = std::max(longest, current + lead);
+                    uint64_t y = seg, run = 0;   // plus longue suite du segment
+                    while (y) { y &= y << 1; run++; }
+                    longest = std::max(longest, run);
+                    current = __builtin_ctzll(~(seg >> (64 - take)));   // suite de queue
+                }
+                bitsInBlock += take;
+                if (bitsInBlock == blockBits) closeBlock();
+                x = (take == 64) ? 0 : x << take;
+                remaining -= take;
+            }
+        }
+    }
+
+    std::vector<NistPValue> pValues() const override {
+        uint64_t blocks = 0;
+        for (uint64_t c : counts) blocks += c;
+        if (blocks == 0) return {{"longest_run", 0.0}};
+        double chi2 = 0;
+        for (int c = 0; c < categories; c++) {
+            double e = blocks * probabilities[c];
+            chi2 += (counts[c] - e) * (counts[c] - e) / e;
+        }
+        return {{"longest_run", gamma_q((categories - 1) / 2.0, chi2 / 2.0)}};
+    }
+};
+
+// ---------------------------- Motifs chevauchants (serial, ApEn) ----------------------------
+
+/**
+ * Compte les motifs de 'width' bits chevauchants, sequence circulaire (les
+ * width - 1 premiers bits sont rajoutes a la fin). Les comptes des largeurs
+ * inferieures s'obtiennent par marginalisation.
+ */
+class OverlappingPatterns {
+private:
+    int width;
+    uint64_t mask;
+    uint64_t window = 0, seen = 0, head = 0;
+
+public:
+    std::vector<uint64_t> counts;
+
+    explicit OverlappingPatterns(int w) : width(w), mask((1ULL << w) - 1), counts(1ULL << w, 0) {}
+
+    void push(uint64_t bit) {
+        window = ((window << 1) | bit) & mask;
+        if (seen < (uint64_t)width - 1) head = (head << 1) | bit;
+        if (++seen >= (uint64_t)width) counts[window]++;
+    }
+
+    void consume(const uint64_t *w, size_t count) {
+        for (size_t i = 0; i < count; i++)
+            for (int b = 63; b >= 0; b--) push((w[i] >> b) & 1);
+    }
+
+    // Ferme la sequence circulaire (a appeler une fois)
+    void finish() {
+        for (int k = width - 2; k >= 0; k--) {
+            window = ((window << 1) | ((head >> k) & 1)) & mask;
+            counts[window]++;
+        }
+    }
+
+    uint64_t bits() const { return seen; }
+
+    // Comptes des motifs de m <= width bits (prefixes)
+    std::vector<uint64_t> marginal(int m) const {
+        std::vector<uint64_t> out(1ULL << m, 0);
+        for (size_t p = 0; p < counts.size(); p++) out[p >> (width - m)] += counts[p];
+        return out;
+    }
+};
+
+inline double psi_squared(const std::vector<uint64_t> &counts, double n) {
+    if (counts.size() <= 1) return 0.0;
+    double sum = 0;
+    for (uint64_t c : counts) sum += (double)c * c;
+    return sum * counts.size() / n - n;
+}
+
+class SerialTest : public StreamTest {
+private:
+    int m;
+    OverlappingPatterns patterns;
+
+public:
+    explicit SerialTest(uint64_t n) : m(std::min(16, (int)std::log2((double)n) - 3)), patterns(m) {}
+
+    void consume(const uint64_t *w, size_t count) override { patterns.consume(w, count); }
+    void finish() override { patterns.finish(); }
+
+    std::vector<NistPValue> pValues() const override {
+        double n = (double)patterns.bits();
+        double p0 = psi_squared(patterns.counts, n);
+        double p1 = psi_squared(patterns.marginal(m - 1), n);
+        double p2 = psi_squared(patterns.marginal(m - 2), n);
+        double d1 = p0 - p1, d2 = p0 - 2 * p1 + p2;
+        return {{"serial_1", gamma_q(std::pow(2.0, m - 2), d1 / 2.0)},
+                {"serial_2", gamma_q(std::pow(2.0, m - 3), d2 / 2.0)}};
+    }
+};
+
+class ApproximateEntropyTest : public StreamTest {
+private:
+    int m;
+    OverlappingPatterns patterns;   // largeur m + 1
+
+    static double phi(const std::vector<uint64_t> &counts, double n) {
+        double sum = 0;
+        for (uint64_t c : counts)
+            if (c) sum += (c / n) * std::log(c / n);
+        return sum;
+    }
+
+public:
+    explicit ApproximateEntropyTest(uint64_t n) : m(std::min(10, (int)std::log2((double)n) - 6)), patterns(m + 1) {}
+
+    void consume(const uint64_t *w, size_t count) override { patterns.consume(w, count); }
+    void finish() override { patterns.finish(); }
+
+    std::vector<NistPValue> pValues() const override {
+        double n = (double)patterns.bits();
+        double apen = phi(patterns.marginal(m), n) - phi(patterns.counts, n);
+        double chi2 = 2.0 * n * (std::log(2.0) - apen);
+        return {{"approximate_entropy", gamma_q(std::pow(2.0, m - 1), chi2 / 2.0)}};
+    }
+};
+
+// ---------------------------- 7. Sommes cumulees ----------------------------
+
+/**
+ * Marche +1/-1 : seuls S_n et les extremes des sommes partielles S_0..S_n
+ * sont gardes (table par octet : variation, max et min des prefixes).
+ * Avant : max |S_k| ; arriere : max |S_n - S_k|.
+ */
+class CumulativeSumsTest : public StreamTest {
+private:
+    struct ByteWalk { int8_t delta, maxPrefix, minPrefix; };
+    ByteWalk table[256];
+    int64_t sum = 0, maxSum = 0, minSum = 0;
+    uint64_t bits = 0;
+
+    static double pValue(double z, double n) {
+        double sqn = std::sqrt(n), sum1 = 0, sum2 = 0;
+        for (int64_t k = (int64_t)((-n / z + 1) / 4); k <= (int64_t)((n / z - 1) / 4); k++)
+            sum1 += normal_cdf((4 * k + 1) * z / sqn) - normal_cdf((4 * k - 1) * z / sqn);
+        for (int64_t k = (int64_t)((-n / z - 3) / 4); k <= (int64_t)((n / z - 1) / 4); k++)
+            sum2 += normal_cdf((4 * k + 3) * z / sqn) - normal_cdf((4 * k + 1) * z / sqn);
+        return 1.0 - sum1 + sum2;
+    }
+
+public:
+    CumulativeSumsTest() {
+        for (int v = 0; v < 256; v++) {
+            int s = 0, hi = -8, lo = 8;
+            for (int b = 7; b >= 0; b--) {
+                s += ((v >> b) & 1) ? 1 : -1;
+                hi = std::max(hi, s);
+                lo = std::min(lo, s);
+            }
+            table[v] = {(int8_t)s, (int8_t)hi, (int8_t)lo};
+        }
+    }
+
+    void consume(const uint64_t *w, size_t count) override {
+        for (size_t i = 0; i < count; i++) {
+            for (int b = 56; b >= 0; b -= 8) {
+                const ByteWalk &t = table[(w[i] >> b) & 0xff];
+                maxSum = std::max(maxSum, sum + t.maxPrefix);
+                minSum = std::min(minSum, sum + t.minPrefix);
+                sum += t.delta;
+            }
+            bits += 64;
+        }
+    }
+
+    std::vector<NistPValue> pValues() const override {
+        double n = (double)bits;
+        double forward = (double)std::max(maxSum, -minSum);
+        double backward = (double)std::max(sum - minSum, maxSum - sum);
+        return {{"cusum_forward", forward > 0 ? pValue(forward, n) : 1.0},
+                {"cusum_backward", backward > 0 ? pValue(backward, n) : 1.0}};
+    }
+};
+
+// ---------------------------- 8. Rang de matrices 32 x 32 ----------------------------
+
+class RankTest : public StreamTest {
+private:
+    uint64_t fullRank = 0, rankMinus1 = 0, matrices = 0;
+    uint32_t rows[32];
+    int filled = 0;
+
+    static int rank32(uint32_t m[32]) {
+        int rank = 0;
+        for (int col = 31; col >= 0 && rank < 32; col--) {
+            uint32_t bit = 1u << col;
+            int pivot = -1;
+            for (int r = rank; r < 32; r++)
+                if (m[r] & bit) { pivot = r; break; }
+            if (pivot < 0) continue;
+            std::swap(m[rank], m[pivot]);
+            for (int r = 0; r < 32; r++)
+                if (r != rank && (m[r] & bit)) m[r] ^= m[rank];
+            rank++;
+        }
+        return rank;
+    }
+
+public:
+    void consume(const uint64_t *w, size_t count) override {
+        for (size_t i = 0; i < count; i++) {
+            rows[filled++] = (uint32_t)(w[i] >> 32);
+            rows[filled++] = (uint32_t)w[i];
+            if (filled == 32) {
+                int r = rank32(rows);
+                if (r == 32) fullRank++;
+                else if (r == 31) rankMinus1++;
+                matrices++;
+                filled = 0;
+            }
+        }
+    }
+
+    std::vector<NistPValue> pValues() const override {
+        if (matrices == 0) return {{"rank", 0.0}};
+        double n = (double)matrices, rest = n - fullRank - rankMinus1;
+        double chi2 = (fullRank - 0.2888 * n) * (fullRank - 0.2888 * n) / (0.2888 * n) +
+                      (rankMinus1 - 0.5776 * n) * (rankMinus1 - 0.5776 * n) / (0.5776 * n) +
+                      (rest - 0.1336 * n) * (rest - 0.1336 * n) / (0.1336 * n);
+        return {{"rank", std::exp(-chi2 / 2.0)}};
+    }
+};
+
+#endif
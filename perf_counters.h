@@ -0,0 +1,242 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+// ==================== COMPTEURS MATERIELS (perf_event_open) ====================
+//
+// Instrumentation optionnelle des noyaux de hachage : cycles, instructions,
+// branch-misses, defauts L1D/LLC et defauts de page autour d'une region de code.
+// Activee a la compilation avec -DAC_PERF_COUNTERS ; sans ce flag, les macros
+// PERF_SCOPE / PERF_REPORT ne generent aucun code.
+// Si le noyau refuse un compteur (VM, perf_event_paranoid, Windows...), la
+// colonne correspondante affiche "n/a" et seul le temps mur reste mesure.
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_PAGE_FAULTS,
+    PERF_EVENT_COUNT
+};
+
+static const char *const PERF_EVENT_NAMES[PERF_EVENT_COUNT] = {
+    "cycles", "instr", "br-miss", "L1D-miss", "LLC-miss", "pg-fault"
+};
+
+/**
+ * Jeu de compteurs ouverts pour le thread courant.
+ * Chaque compteur est ouvert independamment pour qu'un evenement non
+ * supporte n'empeche pas la mesure des autres.
+ */
+class PerfCounters {
+private:
+    int fds[PERF_EVENT_COUNT];
+
+#if defined(__linux__)
+    static int openEvent(uint32_t type, uint64_t config, bool userOnly) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = userOnly ? 1 : 0;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+public:
+    PerfCounters() {
+        for (int i = 0; i < PERF_EVENT_COUNT; i++) fds[i] = -1;
+#if defined(__linux__)
+        const uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D |
+                                     (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        fds[PERF_CYCLES]        = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, true);
+        fds[PERF_INSTRUCTIONS]  = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, true);
+        fds[PERF_BRANCH_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, true);
+        fds[PERF_L1D_MISSES]    = openEvent(PERF_TYPE_HW_CACHE, l1dReadMiss, true);
+        fds[PERF_LLC_MISSES]    = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, true);
+        fds[PERF_PAGE_FAULTS]   = openEvent(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, false);
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int i = 0; i < PERF_EVENT_COUNT; i++)
+            if (fds[i] >= 0) close(fds[i]);
+#endif
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool available(int event) const { return fds[event] >= 0; }
+
+    bool anyAvailable() const {
+        for (int i = 0; i < PERF_EVENT_COUNT; i++)
+            if (fds[i] >= 0) return true;
+        return false;
+    }
+
+    void start() {
+#if defined(__linux__)
+        for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /**
+     * Arrete les compteurs et ecrit les valeurs (corrigees du multiplexage)
+     */
+    void stop(uint64_t values[PERF_EVENT_COUNT]) {
+        for (int i = 0; i < PERF_EVENT_COUNT; i++) values[i] = 0;
+#if defined(__linux__)
+        for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+            if (fds[i] < 0) continue;
+            ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t data[3] = {0, 0, 0}; // valeur, temps active, temps effectif
+            if (read(fds[i], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+            if (data[2] > 0 && data[2] < data[1])
+                values[i] = static_cast<uint64_t>(data[0] * ((double)data[1] / data[2]));
+            else
+                values[i] = data[0];
+        }
+#endif
+    }
+};
+
+/**
+ * Statistiques accumulees pour une region nommee (ac_hash, sha256, ...)
+ */
+struct PerfRegion {
+    PerfCounters counters;
+    uint64_t calls = 0;
+    uint64_t ops = 0;          // nombre de hashs effectues dans la region
+    double wallMs = 0;
+    uint64_t totals[PERF_EVENT_COUNT] = {0, 0, 0, 0, 0, 0};
+};
+
+inline std::map<std::string, PerfRegion> &perf_regions() {
+    static std::map<std::string, PerfRegion> regions;
+    return regions;
+}
+
+inline PerfRegion &perf_region(const std::string &name) {
+    return perf_regions()[name];
+}
+
+/**
+ * Mesure RAII : demarre les compteurs a la construction, accumule a la destruction.
+ * Le nombre d'operations peut etre fixe apres coup (ex: iterations de minage).
+ */
+class PerfScope {
+private:
+    PerfRegion &region;
+    uint64_t ops;
+    std::chrono::high_resolution_clock::time_point start;
+
+public:
+    PerfScope(PerfRegion &r, uint64_t n = 1) : region(r), ops(n) {
+        region.counters.start();
+        start = std::chrono::high_resolution_clock::now();
+    }
+
+    void setOps(uint64_t n) { ops = n; }
+
+    ~PerfScope() {
+        auto end = std::chrono::high_resolution_clock::now();
+        uint64_t values[PERF_EVENT_COUNT];
+        region.counters.stop(values);
+        region.calls++;
+        region.ops += ops;
+        region.wallMs += std::chrono::duration<double, std::milli>(end - start).count();
+        for (int i = 0; i < PERF_EVENT_COUNT; i++) region.totals[i] += values[i];
+    }
+};
+
+/**
+ * Affiche temps mur, IPC et compteurs par hash pour chaque region mesuree
+ */
+inline void perf_report(std::ostream &os = std::cout) {
+    const std::map<std::string, PerfRegion> &regions = perf_regions();
+    if (regions.empty()) return;
+
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision();
+
+    os << "\n=== COMPTEURS MATERIELS (par hash) ===\n";
+    os << std::left << std::setw(14) << "Region" << std::right
+       << std::setw(10) << "Hashs" << std::setw(12) << "Mur (ms)" << std::setw(12) << "us/hash"
+       << std::setw(7) << "IPC";
+    for (int i = 0; i < PERF_EVENT_COUNT; i++) os << std::setw(11) << PERF_EVENT_NAMES[i];
+    os << "\n" << std::string(14 + 10 + 12 + 12 + 7 + 11 * PERF_EVENT_COUNT, '-') << "\n";
+
+    bool anyCounter = false;
+    for (const auto &entry : regions) {
+        const PerfRegion &r = entry.second;
+        double ops = r.ops > 0 ? (double)r.ops : 1.0;
+        os << std::left << std::setw(14) << entry.first << std::right << std::fixed
+           << std::setw(10) << r.ops
+           << std::setw(12) << std::setprecision(3) << r.wallMs
+           << std::setw(12) << std::setprecision(3) << (r.wallMs * 1000.0 / ops);
+
+        if (r.counters.available(PERF_CYCLES) && r.counters.available(PERF_INSTRUCTIONS) &&
+            r.totals[PERF_CYCLES] > 0) {
+            os << std::setw(7) << std::setprecision(2)
+               << (double)r.totals[PERF_INSTRUCTIONS] / r.totals[PERF_CYCLES];
+        } else {
+            os << std::setw(7) << "n/a";
+        }
+
+        for (int i = 0; i < PERF_EVENT_COUNT; i++) {
+            if (r.counters.available(i)) {
+                anyCounter = true;
+                os << std::setw(11) << std::setprecision(1) << r.totals[i] / ops;
+            } else {
+                os << std::setw(11) << "n/a";
+            }
+        }
+        os << "\n";
+    }
+
+    if (!anyCounter)
+        os << "  (compteurs materiels indisponibles : verifier /proc/sys/kernel/perf_event_paranoid)\n";
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+#ifdef AC_PERF_COUNTERS
+#define PERF_SCOPE(var, name, ops) PerfScope var(perf_region(name), ops)
+#define PERF_REPORT() perf_report()
+#else
+struct PerfScopeNoop {
+    void setOps(uint64_t) {}
+};
+#define PERF_SCOPE(var, name, ops) [[maybe_unused]] PerfScopeNoop var
+#define PERF_REPORT() ((void)0)
+#endif
+
+#endif
@@ -7,7 +7,7 @@ set EXE_FILE=hash_test.exe
 set SRC_FILE=Exercice1.cpp
 
 echo Compiling %SRC_FILE% ...
-g++ -std=c++17 -O3 -o %EXE_FILE% %SRC_FILE%
+g++ -std=c++17 -O3 -o %EXE_FILE% %SRC_FILE% achash.cpp sha256.cpp
 if errorlevel 1 (
     echo Compilation failed!
     pause
@@ -4,7 +4,7 @@ echo AC-Hash+ Automated Test Runner
 echo ==============================================
 
 echo Compiling Exercice10.cpp ...
-g++ -std=c++17 -O3 -o hash_test.exe Exercice10.cpp
+g++ -std=c++17 -O3 -o hash_test.exe Exercice10.cpp achash.cpp sha256.cpp
 if errorlevel 1 (
     echo  Compilation failed!
     pause
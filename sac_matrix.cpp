@@ -0,0 +1,267 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include "achash.h"
+#include "avalanche.h"
+#include "digest_stats.h"
+#include "logger.h"
+#include "trace.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// ==================== MATRICE SAC (STRICT AVALANCHE CRITERION) ====================
+//
+// Pour chaque echantillon (message aleatoire de longueur fixe), chaque bit
+// d'entree i est inverse et l'on compte, pour chaque bit de sortie j, combien
+// de fois il change : P[i][j] doit valoir 0.5. Les 64 variantes d'un meme
+// paquet de bits d'entree sont hachees ensemble (ac_hash_sliced) : le mot
+// W[j] contient directement le changement du bit j pour 64 bits d'entree.
+// Independance des bits de sortie (BIC) : correlation entre les changements
+// des bits j et k, sur toutes les inversions.
+
+struct SacConfig {
+    string variant = "ac";       // ac | plus
+    size_t length = 64;          // octets par message (512 bits d'entree)
+    size_t samples = 1000;
+    uint32_t rule = 110;
+    size_t steps = 10;
+    unsigned threads = 0;        // 0 : tous les coeurs
+    uint64_t seed = 2024;
+    string prefix = "sac";
+    bool binary = false;         // csv ou binaire
+};
+
+/**
+ * Compteurs d'un thread. Les changements d'un paquet b de 64 bits d'entree
+ * sont comptes par groupes de 4 bits de sortie dans un BitPositionCounter :
+ * position (j % 4) * 64 + 63 - l  <->  (bit d'entree 64b + l, bit de sortie j).
+ */
+struct SacAccumulator {
+    size_t batches;
+    vector<BitPositionCounter> flips;   // batches * 64
+    vector<uint64_t> pairs;             // 256 x 256, triangle superieur (j < k)
+    vector<uint64_t> ones;              // changements par bit de sortie
+    uint64_t samples = 0;
+
+    explicit SacAccumulator(size_t b) : batches(b), flips(b * 64), pairs(256 * 256, 0), ones(256, 0) {}
+
+    uint64_t flipCount(size_t inputBit, int outputBit) {
+        BitPositionCounter &c = flips[(inputBit / 64) * 64 + outputBit / 4];
+        return c.ones()[(outputBit % 4) * 64 + 63 - inputBit % 64];
+    }
+};
+
+// Bit d'entree i = bit (7 - i % 8) de l'octet i / 8 (ordre de lecture des hashs)
+static void flip_input_bit(string &message, size_t bit) {
+    message[bit / 8] ^= static_cast<char>(0x80 >> (bit % 8));
+}
+
+static void sac_sample(const SacConfig &cfg, uint64_t sample, SacAccumulator &acc,
+                       vector<string> &lanes, string &base) {
+    CounterRng rng(cfg.seed, sample);
+    base.resize(cfg.length);
+    for (size_t k = 0; k < cfg.length; k++)
+        base[k] = static_cast<char>(rng.at(k / 8) >> (8 * (k % 8)));
+
+    bool plus = (cfg.variant == "plus");
+    Digest256 h0 = plus ? ac_hash_plus_digest(base, cfg.rule, cfg.steps)
+                        : ac_hash_digest(base, cfg.rule, cfg.steps);
+
+    size_t inputBits = 8 * cfg.length;
+    uint64_t sliced[256];
+    uint64_t diff[256];
+    for (size_t b = 0; b < acc.batches; b++) {
+        size_t first = 64 * b;
+        size_t n = min<size_t>(64, inputBits - first);
+        for (size_t l = 0; l < n; l++) {
+            lanes[l] = base;
+            flip_input_bit(lanes[l], first + l);
+        }
+        if (plus) ac_hash_plus_sliced(lanes.data(), n, cfg.rule, cfg.steps, sliced);
+        else ac_hash_sliced(lanes.data(), n, cfg.rule, cfg.steps, sliced);
+
+        uint64_t active = (n == 64) ? ~0ULL : ((1ULL << n) - 1);
+        for (int j = 0; j < 256; j++)
+            diff[j] = (sliced[j] ^ (digest_bit(h0, j) ? ~0ULL : 0ULL)) & active;
+
+        for (int g = 0; g < 64; g++)
+            acc.flips[b * 64 + g].add({diff[4 * g], diff[4 * g + 1], diff[4 * g + 2], diff[4 * g + 3]});
+
+        for (int j = 0; j < 256; j++) {
+            if (!diff[j]) continue;
+            acc.ones[j] += __builtin_popcountll(diff[j]);
+            uint64_t *row = &acc.pairs[j * 256];
+            for (int k = j + 1; k < 256; k++)
+                row[k] += __builtin_popcountll(diff[j] & diff[k]);
+        }
+    }
+    acc.samples++;
+}
+
+static bool write_matrix(const string &path, const vector<double> &m, size_t rows, size_t cols, bool binary) {
+    if (binary) {
+        ofstream out(path, ios::binary);
+        if (!out) return false;
+        uint32_t header[2] = {static_cast<uint32_t>(rows), static_cast<uint32_t>(cols)};
+        out.write("SAC1", 4);
+        out.write(reinterpret_cast<const char *>(header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(m.data()), m.size() * sizeof(double));
+        return static_cast<bool>(out);
+    }
+    ofstream out(path);
+    if (!out) return false;
+    out << fixed << setprecision(6);
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t c = 0; c < cols; c++)
+            out << (c ? "," : "") << m[r * cols + c];
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+// Usage : sac_matrix [ac|plus] [longueur] [echantillons] [regle] [etapes] [threads] [prefixe] [csv|bin]
+int main(int argc, char **argv) {
+    SacConfig cfg;
+    if (argc > 1) cfg.variant = argv[1];
+    if (argc > 2) cfg.length = stoul(argv[2]);
+    if (argc > 3) cfg.samples = stoul(argv[3]);
+    if (argc > 4) cfg.rule = static_cast<uint32_t>(stoul(argv[4]));
+    if (argc > 5) cfg.steps = stoul(argv[5]);
+    if (argc > 6) cfg.threads = static_cast<unsigned>(stoul(argv[6]));
+    if (argc > 7) cfg.prefix = argv[7];
+    if (argc > 8) cfg.binary = (string(argv[8]) == "bin");
+
+    if ((cfg.variant != "ac" && cfg.variant != "plus") || cfg.length == 0 || cfg.samples == 0) {
+        cerr << "Usage: sac_matrix [ac|plus] [longueur>0] [echantillons>0] [regle] [etapes] [threads] [prefixe] [csv|bin]" << endl;
+        return 1;
+    }
+
+    unsigned threads = cfg.threads ? cfg.threads : thread::hardware_concurrency();
+    if (threads == 0) threads = 1;
+    size_t inputBits = 8 * cfg.length;
+    size_t batches = (inputBits + 63) / 64;
+
+    cout << "==============================================" << endl;
+    cout << "MATRICE SAC - " << (cfg.variant == "plus" ? "AC-Hash+" : "AC_HASH") << endl;
+    cout << "==============================================" << endl;
+    cout << "Regle: " << cfg.rule << ", Etapes: " << cfg.steps << ", Message: " << cfg.length
+         << " octets (" << inputBits << " bits d'entree)" << endl;
+    cout << "Echantillons: " << cfg.samples << ", Threads: " << threads << ", Graine: " << cfg.seed << endl;
+
+    vector<SacAccumulator> partial;
+    for (unsigned t = 0; t < threads; t++) partial.emplace_back(batches);
+
+    atomic<size_t> next{0};
+    size_t reportEvery = max<size_t>(1, cfg.samples / 10);
+    auto start = steady_clock::now();
+
+    auto worker = [&](unsigned t) {
+        TRACE_SCOPE_ARG("sac_worker", "thread", t);
+        vector<string> lanes(64);
+        string base;
+        for (;;) {
+            size_t s = next.fetch_add(1, memory_order_relaxed);
+            if (s >= cfg.samples) break;
+            sac_sample(cfg, s, partial[t], lanes, base);
+            if ((s + 1) % reportEvery == 0)
+                LOG_INFO("Progression: {}/{} echantillons", s + 1, cfg.samples);
+        }
+    };
+    vector<thread> pool;
+    for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker, t);
+    worker(0);
+    for (thread &th : pool) th.join();
+    log_flush();
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    // Fusion
+    vector<double> sac(inputBits * 256, 0.0);
+    vector<uint64_t> ones(256, 0), pairs(256 * 256, 0);
+    for (SacAccumulator &acc : partial) {
+        for (size_t i = 0; i < inputBits; i++)
+            for (int j = 0; j < 256; j++)
+                sac[i * 256 + j] += acc.flipCount(i, j);
+        for (int j = 0; j < 256; j++) ones[j] += acc.ones[j];
+        for (size_t p = 0; p < pairs.size(); p++) pairs[p] += acc.pairs[p];
+    }
+    double n = static_cast<double>(cfg.samples);
+    for (double &p : sac) p /= n;
+
+    // Statistiques SAC : z = (p - 0.5) / (0.5 / sqrt(n)), somme des z^2 ~ chi2
+    const double Z_999 = 3.2905;  // bilateral 99.9 %
+    double sigma = 0.5 / sqrt(n);
+    double maxDeviation = 0, sumDeviation = 0, chi2 = 0;
+    size_t outside = 0, worstInput = 0;
+    double worstInputDeviation = 0;
+    for (size_t i = 0; i < inputBits; i++) {
+        double rowDeviation = 0;
+        for (int j = 0; j < 256; j++) {
+            double d = fabs(sac[i * 256 + j] - 0.5);
+            maxDeviation = max(maxDeviation, d);
+            sumDeviation += d;
+            rowDeviation += d;
+            chi2 += (d / sigma) * (d / sigma);
+            if (d > Z_999 * sigma) outside++;
+        }
+        if (rowDeviation > worstInputDeviation) {
+            worstInputDeviation = rowDeviation;
+            worstInput = i;
+        }
+    }
+    size_t cells = inputBits * 256;
+
+    // BIC : correlation de Pearson entre changements des bits j et k
+    double total = n * inputBits;
+    vector<double> bic(256 * 256, 0.0);
+    double maxCorrelation = 0, sumCorrelation = 0;
+    int worstJ = 0, worstK = 1;
+    for (int j = 0; j < 256; j++) {
+        bic[j * 256 + j] = 1.0;
+        for (int k = j + 1; k < 256; k++) {
+            double pj = ones[j] / total, pk = ones[k] / total, pjk = pairs[j * 256 + k] / total;
+            double denom = sqrt(pj * (1 - pj) * pk * (1 - pk));
+            double r = denom > 0 ? (pjk - pj * pk) / denom : 0.0;
+            bic[j * 256 + k] = bic[k * 256 + j] = r;
+            sumCorrelation += fabs(r);
+            if (fabs(r) > maxCorrelation) {
+                maxCorrelation = fabs(r);
+                worstJ = j;
+                worstK = k;
+            }
+        }
+    }
+
+    cout << fixed << setprecision(2);
+    cout << "\nTemps: " << seconds << " s (" << setprecision(0)
+         << (cfg.samples * (inputBits + 1)) / seconds << " hashs/s)" << endl;
+
+    cout << setprecision(4);
+    cout << "\n=== SAC (" << inputBits << " x 256) ===" << endl;
+    cout << "Deviation moyenne |P - 0.5|: " << sumDeviation / cells << endl;
+    cout << "Deviation maximale: " << maxDeviation << " (ecart-type attendu: " << sigma << ")" << endl;
+    cout << "Cellules hors intervalle 99.9%: " << outside << " / " << cells
+         << " (attendu: ~" << setprecision(1) << cells * 0.001 << ")" << endl;
+    cout << setprecision(4) << "Chi-carre global: " << setprecision(1) << chi2 << " (ddl " << cells
+         << "), p-value: " << setprecision(4) << chi2_pvalue(chi2, static_cast<int>(cells)) << endl;
+    cout << "Bit d'entree le plus faible: " << worstInput << " (deviation moyenne "
+         << worstInputDeviation / 256 << ")" << endl;
+
+    cout << "\n=== BIC (independance des bits de sortie) ===" << endl;
+    cout << "Correlation moyenne |r|: " << sumCorrelation / (256 * 255 / 2) << endl;
+    cout << "Correlation maximale |r|: " << maxCorrelation << " (bits " << worstJ << ", " << worstK
+         << "), attendu ~" << 1 / sqrt(total) << " par paire" << endl;
+
+    string ext = cfg.binary ? ".bin" : ".csv";
+    string sacPath = cfg.prefix + "_sac" + ext, bicPath = cfg.prefix + "_bic" + ext;
+    bool ok = write_matrix(sacPath, sac, inputBits, 256, cfg.binary) &&
+              write_matrix(bicPath, bic, 256, 256, cfg.binary);
+    cout << "\nMatrices ecrites: " << sacPath << ", " << bicPath << (ok ? "" : " (ECHEC)") << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+#ifndef SEQUENTIAL_H
+#define SEQUENTIAL_H
+
+// ==================== ECHANTILLONNAGE SEQUENTIEL ====================
+//
+// Les tests de qualite (exercices 5, 6, 7, 10) estiment une moyenne (bits
+// changes, bits a 1) dont la valeur ideale est 50 %. Au lieu d'un nombre
+// fixe d'echantillons, l'estimateur accumule en flux (Welford, sans stocker
+// les valeurs) et s'arrete des que :
+//   - l'intervalle de confiance est plus etroit que la tolerance demandee, ou
+//   - un test sequentiel de Wald (SPRT) tranche entre "moyenne = cible" et
+//     "moyenne a +/- delta de la cible".
+// Une configuration correcte s'arrete donc tot ; une configuration limite
+// recoit automatiquement plus d'echantillons (jusqu'a maxSamples).
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Moyenne et variance en une passe (algorithme de Welford)
+ */
+class RunningStats {
+private:
+    size_t n = 0;
+    double m = 0;
+    double m2 = 0;
+
+public:
+    void add(double x) {
+        n++;
+        double delta = x - m;
+        m += delta / n;
+        m2 += delta * (x - m);
+    }
+
+    size_t count() const { return n; }
+    double mean() const { return m; }
+    double variance() const { return n > 1 ? m2 / (n - 1) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+    double standardError() const { return n > 0 ? std::sqrt(variance() / n) : 0.0; }
+};
+
+struct SequentialConfig {
+    double target = 50.0;       // moyenne ideale (en %)
+    double tolerance = 0.5;     // demi-largeur d'intervalle visee (en %)
+    double delta = 2.0;         // ecart juge inacceptable par le SPRT (en %)
+    double confidence = 0.99;   // niveau de l'intervalle
+    double alpha = 0.01;        // risque de rejeter une bonne configuration
+    double beta = 0.01;         // risque d'accepter une mauvaise
+    size_t minSamples = 30;     // avant toute decision (variance estimee)
+    size_t maxSamples = 1000;
+    bool sprt = true;           // false : arret sur la seule largeur d'intervalle
+};
+
+enum class SequentialDecision { CONTINUE, PRECISE, PASS, FAIL, EXHAUSTED };
+
+inline const char *decision_name(SequentialDecision d) {
+    switch (d) {
+        case SequentialDecision::PRECISE:   return "intervalle atteint";
+        case SequentialDecision::PASS:      return "SPRT: conforme";
+        case SequentialDecision::FAIL:      return "SPRT: non conforme";
+        case SequentialDecision::EXHAUSTED: return "maximum atteint";
+        default:                            return "en cours";
+    }
+}
+
+// Quantile z de la loi normale pour un intervalle bilateral (Acklam, |erreur| < 1e-9)
+inline double normal_quantile_two_sided(double confidence) {
+    double p = 1.0 - (1.0 - confidence) / 2.0;
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    if (p > 0.97575) {
+        double q = std::sqrt(-2 * std::log(1 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+    }
+    double q = p - 0.5, r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+/**
+ * Estimateur sequentiel d'une moyenne. add() renvoie CONTINUE tant qu'il
+ * faut d'autres echantillons ; la decision est figee une fois prise.
+ *
+ * SPRT bilateral sur une moyenne gaussienne (variance estimee) : pour
+ * H1 : mu = cible +/- delta contre H0 : mu = cible, le log-rapport de
+ * vraisemblance apres n valeurs de moyenne xbar vaut
+ *     n * d * (xbar - cible - d / 2) / sigma^2   avec d = +delta ou -delta.
+ * FAIL si l'un des deux depasse log((1 - beta) / alpha), PASS si les deux
+ * sont sous log(beta / (1 - alpha)).
+ */
+class SequentialEstimator {
+private:
+    SequentialConfig cfg;
+    RunningStats stats;
+    double z;
+    SequentialDecision state = SequentialDecision::CONTINUE;
+
+    double logLikelihoodRatio(double d) const {
+        double variance = stats.variance();
+        if (variance <= 0) variance = 1e-12;
+        return stats.count() * d * (stats.mean() - cfg.target - d / 2) / variance;
+    }
+
+public:
+    explicit SequentialEstimator(const SequentialConfig &config = SequentialConfig())
+        : cfg(config), z(normal_quantile_two_sided(config.confidence)) {}
+
+    SequentialDecision add(double x) {
+        stats.add(x);
+        if (state != SequentialDecision::CONTINUE) return state;
+        if (stats.count() < cfg.minSamples) return state;
+
+        double upper = std::log((1 - cfg.beta) / cfg.alpha);
+        double lower = std::log(cfg.beta / (1 - cfg.alpha));
+        double high = logLikelihoodRatio(cfg.delta), low = logLikelihoodRatio(-cfg.delta);
+
+        if (cfg.sprt && (high >= upper || low >= upper)) state = SequentialDecision::FAIL;
+        else if (halfWidth() <= cfg.tolerance) state = SequentialDecision::PRECISE;
+        else if (cfg.sprt && high <= lower && low <= lower) state = SequentialDecision::PASS;
+        else if (stats.count() >= cfg.maxSamples) state = SequentialDecision::EXHAUSTED;
+        return state;
+    }
+
+    bool done() const { return state != SequentialDecision::CONTINUE; }
+    SequentialDecision decision() const { return state; }
+    const RunningStats &statistics() const { return stats; }
+    size_t count() const { return stats.count(); }
+    double mean() const { return stats.mean(); }
+
+    // Demi-largeur de l'intervalle de confiance (z * erreur standard)
+    double halfWidth() const { return z * stats.standardError(); }
+
+    // Conforme si l'intervalle ne sort pas de [cible - delta, cible + delta]
+    bool acceptable() const {
+        if (state == SequentialDecision::FAIL) return false;
+        if (state == SequentialDecision::PASS) return true;
+        return std::fabs(stats.mean() - cfg.target) + halfWidth() <= cfg.delta;
+    }
+
+    std::string summary(int precision = 2) const {
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), "%.*f%% +/- %.*f (n = %zu, %s)", precision, stats.mean(),
+                 precision, halfWidth(), stats.count(), decision_name(state));
+        return buffer;
+    }
+};
+
+// ---------------------------- Comparaison de configurations ----------------------------
+
+/**
+ * Reglage pour classer des configurations (exercices 7 et 10) : le SPRT
+ * arrete une bonne configuration vers 30 echantillons (+/- 1,4 %), bien trop
+ * large pour departager des candidats tous proches de 50 %. Arret sur la
+ * seule largeur d'intervalle, +/- 0,15 % (environ 2900 echantillons pour
+ * une empreinte de 256 bits).
+ */
+inline SequentialConfig comparison_config(size_t maxSamples = 4096) {
+    SequentialConfig cfg;
+    cfg.sprt = false;
+    cfg.tolerance = 0.15;
+    cfg.maxSamples = maxSamples;
+    return cfg;
+}
+
+/**
+ * Meilleur score si son intervalle [score - marge, score + marge] ne recoupe
+ * aucun autre ; sinon -1 et 'tied' recoit les candidats compatibles avec le
+ * meilleur (egalite statistique).
+ */
+inline int best_separated(const std::vector<double> &score, const std::vector<double> &margin,
+                          std::vector<size_t> &tied) {
+    tied.clear();
+    if (score.empty()) return -1;
+    size_t best = 0;
+    for (size_t i = 1; i < score.size(); i++)
+        if (score[i] > score[best]) best = i;
+    for (size_t i = 0; i < score.size(); i++)
+        if (score[i] + margin[i] >= score[best] - margin[best]) tied.push_back(i);
+    return tied.size() == 1 ? static_cast<int>(best) : -1;
+}
+
+#endif
@@ -1,3 +1,5 @@
+#include "achash.h"
+#include "metrics.h"
 #include <cstring>
 #include <fstream>
 #include <sstream>
@@ -33,6 +35,8 @@ static const uint32 k[64] = {
 };
 
 string sha256(const string &data) {
+    METRIC_ADD(METRIC_HASH_SHA256, 1);
+
     uint32 h0 = 0x6a09e667;
     uint32 h1 = 0xbb67ae85;
     uint32 h2 = 0x3c6ef372;
@@ -0,0 +1,357 @@
+#ifndef SPACETIME_RENDER_H
+#define SPACETIME_RENDER_H
+
+// ==================== DIAGRAMME ESPACE-TEMPS : RENDU EN FLUX ====================
+//
+// Ecrit le diagramme espace-temps (une ligne d'image par generation) dans un
+// fichier PBM / PGM ou PNG au fil de la simulation. push() ne fait que copier
+// la ligne empaquetee dans une file bornee ; un thread de fond la reduit,
+// la convertit et l'ecrit. Aucune mise en forme texte : le debit est celui
+// du disque.
+//
+// Sous-echantillonnage par blocs de B x B cellules (B generations de B
+// cellules) pour les tres grands diagrammes :
+//   * MAX     : pixel noir si une cellule du bloc vaut 1 (image 1 bit) ;
+//   * AVERAGE : niveau de gris selon la proportion de 1 (image 8 bits).
+//
+// Format selon l'extension : ".png" (deflate en blocs stockes, sans
+// compression, donc sans dependance), sinon netpbm binaire (P4 en 1 bit,
+// P5 en gris). La hauteur est fixee a la construction (en-tetes ecrits
+// d'emblee) : les lignes manquantes a finish() sont completees par des 0,
+// les lignes en trop sont ignorees.
+
+#include "cellular_automaton.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ---------------------------- Sommes de controle PNG ----------------------------
+
+// CRC-32 (polynome 0xEDB88320) par tranches de 8 octets : t[k][b] = CRC de b suivi de k octets nuls
+inline uint32_t png_crc32(uint32_t crc, const uint8_t *data, size_t n) {
+    static const std::vector<uint32_t> table = [] {
+        std::vector<uint32_t> t(8 * 256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i)
+            for (int k = 1; k < 8; ++k) t[k * 256 + i] = t[(k - 1) * 256 + i] >> 8 ^ t[t[(k - 1) * 256 + i] & 0xFF];
+        return t;
+    }();
+    const uint32_t *t = table.data();
+    crc = ~crc;
+    for (; n >= 8; n -= 8, data += 8) {
+        uint32_t lo, hi;
+        memcpy(&lo, data, 4);
+        memcpy(&hi, data + 4, 4);
+        lo ^= crc;
+        crc = t[7 * 256 + (lo & 0xFF)] ^ t[6 * 256 + (lo >> 8 & 0xFF)] ^ t[5 * 256 + (lo >> 16 & 0xFF)] ^
+              t[4 * 256 + (lo >> 24)] ^ t[3 * 256 + (hi & 0xFF)] ^ t[2 * 256 + (hi >> 8 & 0xFF)] ^
+              t[256 + (hi >> 16 & 0xFF)] ^ t[hi >> 24];
+    }
+    for (; n; --n) crc = t[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+inline uint32_t adler32(uint32_t adler, const uint8_t *data, size_t n) {
+    uint32_t a = adler & 0xFFFF, b = adler >> 16;
+    while (n) {
+        size_t chunk = n < 5552 ? n : 5552;   // pas de debordement avant le modulo
+        n -= chunk;
+        while (chunk--) {
+            a += *data++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+// ---------------------------- Cellules d'un intervalle ----------------------------
+
+// Nombre de 1 parmi les cellules [lo, hi) d'un etat empaquete
+inline uint64_t packed_count(const uint64_t *words, size_t lo, size_t hi) {
+    if (lo >= hi) return 0;
+    size_t first = lo >> 6, last = (hi - 1) >> 6;
+    uint64_t head = ~0ULL << (lo & 63), tail = ~0ULL >> (63 - ((hi - 1) & 63));
+    if (first == last) return __builtin_popcountll(words[first] & head & tail);
+    uint64_t count = __builtin_popcountll(words[first] & head) + __builtin_popcountll(words[last] & tail);
+    for (size_t w = first + 1; w < last; ++w) count += __builtin_popcountll(words[w]);
+    return count;
+}
+
+inline bool packed_any(const uint64_t *words, size_t lo, size_t hi) {
+    if (lo >= hi) return false;
+    size_t first = lo >> 6, last = (hi - 1) >> 6;
+    uint64_t head = ~0ULL << (lo & 63), tail = ~0ULL >> (63 - ((hi - 1) & 63));
+    if (first == last) return (words[first] & head & tail) != 0;
+    if ((words[first] & head) || (words[last] & tail)) return true;
+    for (size_t w = first + 1; w < last; ++w)
+        if (words[w]) return true;
+    return false;
+}
+
+// ---------------------------- Rendu ----------------------------
+
+class SpaceTimeRenderer {
+public:
+    enum class Pooling { MAX, AVERAGE };
+
+private:
+    static constexpr size_t QUEUE_ROWS = 64;           // lignes en attente au plus
+    static constexpr size_t STORED_BLOCK = 65535;      // taille max d'un bloc deflate stocke
+    static constexpr size_t IDAT_BYTES = 1 << 20;      // taille des morceaux IDAT
+
+    const size_t cells, rows, block;
+    const size_t words;
+    const Pooling pooling;
+    const bool png, gray;
+    size_t width_, height_, row_bytes;
+
+    FILE *file = nullptr;
+    bool failed = false;
+    bool finished = false;
+
+    // File bornee producteur -> thread d'ecriture
+    std::vector<std::vector<uint64_t>> queue;
+    size_t head = 0, tail = 0;                     // lignes deposees / consommees
+    size_t pushed = 0;
+    bool closing = false;
+    std::mutex mutex;
+    std::condition_variable not_empty, not_full;
+    std::thread writer;
+
+    // Etat du thread d'ecriture
+    size_t consumed = 0;                           // lignes de cellules traitees
+    std::vector<uint64_t> rows_or;                 // MAX : OU des lignes du bloc
+    std::vector<uint32_t> counts;                  // AVERAGE : 1 par pixel
+    std::vector<uint8_t> scanline;
+    std::vector<uint8_t> stored, idat;             // PNG : bloc deflate en cours, chunk IDAT en cours
+    uint32_t adler = 1;
+
+    void write(const void *data, size_t n) {
+        if (!failed && n && fwrite(data, 1, n, file) != n) failed = true;
+    }
+
+    void write_be32(uint32_t v) {
+        uint8_t b[4] = {uint8_t(v >> 24), uint8_t(v >> 16), uint8_t(v >> 8), uint8_t(v)};
+        write(b, 4);
+    }
+
+    void write_chunk(const char *type, const uint8_t *data, size_t n) {
+        write_be32(static_cast<uint32_t>(n));
+        write(type, 4);
+        write(data, n);
+        uint32_t crc = png_crc32(0, reinterpret_cast<const uint8_t *>(type), 4);
+        write_be32(png_crc32(crc, data, n));
+    }
+
+    void write_header() {
+        if (!png) {
+            std::string header = std::string(gray ? "P5" : "P4") + "\n" + std::to_string(width_) + " " +
+                                 std::to_string(height_) + "\n" + (gray ? "255\n" : "");
+            write(header.data(), header.size());
+            return;
+        }
+        static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        write(signature, 8);
+        uint8_t ihdr[13] = {uint8_t(width_ >> 24), uint8_t(width_ >> 16), uint8_t(width_ >> 8), uint8_t(width_),
+                            uint8_t(height_ >> 24), uint8_t(height_ >> 16), uint8_t(height_ >> 8), uint8_t(height_),
+                            uint8_t(gray ? 8 : 1), 0, 0, 0, 0};   // niveaux de gris, sans entrelacement
+        write_chunk("IHDR", ihdr, sizeof(ihdr));
+        idat = {0x78, 0x01};                       // en-tete zlib
+    }
+
+    // Blocs deflate stockes : BFINAL, LEN, ~LEN puis les octets bruts
+    void emit_stored(bool final) {
+        size_t n = stored.size();
+        uint8_t header[5] = {uint8_t(final ? 1 : 0), uint8_t(n), uint8_t(n >> 8), uint8_t(~n), uint8_t(~n >> 8)};
+        idat.insert(idat.end(), header, header + 5);
+        idat.insert(idat.end(), stored.begin(), stored.end());
+        stored.clear();
+        if (idat.size() >= IDAT_BYTES) {
+            write_chunk("IDAT", idat.data(), idat.size());
+            idat.clear();
+        }
+    }
+
+    void png_append(const uint8_t *data, size_t n) {
+        adler = adler32(adler, data, n);
+        while (n) {
+            size_t take = std::min(n, STORED_BLOCK - stored.size());
+            stored.insert(stored.end(), data, data + take);
+            data += take;
+            n -= take;
+            if (stored.size() == STORED_BLOCK) emit_stored(false);
+        }
+    }
+
+    void write_trailer() {
+        if (!png) return;
+        emit_stored(true);
+        uint8_t check[4] = {uint8_t(adler >> 24), uint8_t(adler >> 16), uint8_t(adler >> 8), uint8_t(adler)};
+        idat.insert(idat.end(), check, check + 4);
+        write_chunk("IDAT", idat.data(), idat.size());
+        write_chunk("IEND", nullptr, 0);
+    }
+
+    // Une ligne de l'image a partir du bloc de 'span' generations accumule
+    void emit_scanline(size_t span) {
+        uint8_t *out = scanline.data() + 1;        // octet 0 : filtre PNG (aucun)
+        if (gray) {
+            for (size_t j = 0; j < width_; ++j) {
+                size_t area = std::min(block, cells - j * block) * span;
+                out[j] = static_cast<uint8_t>(255 - (255 * counts[j] + area / 2) / area);
+                counts[j] = 0;
+            }
+        } else {
+            std::fill(out, out + row_bytes, 0);
+            if (block == 1) {
+                // Cellule i : bit (i & 63) du mot ; pixel i : bit de poids fort d'abord
+                for (size_t i = 0; i < row_bytes; ++i) {
+                    uint32_t b = static_cast<uint8_t>(rows_or[i >> 3] >> (8 * (i & 7)));
+                    // Inversion des 8 bits par multiplications 32 bits
+                    out[i] = static_cast<uint8_t>(((b * 0x0802u & 0x22110u) | (b * 0x8020u & 0x88440u)) * 0x10101u >> 16);
+                }
+            } else {
+                for (size_t j = 0; j < width_; ++j)
+                    if (packed_any(rows_or.data(), j * block, std::min(cells, (j + 1) * block)))
+                        out[j >> 3] |= static_cast<uint8_t>(0x80 >> (j & 7));
+            }
+            if (width_ & 7) out[row_bytes - 1] &= static_cast<uint8_t>(0xFF00 >> (width_ & 7));
+            if (png)                               // PNG 1 bit : 0 = noir
+                for (size_t i = 0; i < row_bytes; ++i) out[i] = static_cast<uint8_t>(~out[i]);
+            std::fill(rows_or.begin(), rows_or.end(), 0);
+        }
+        if (png) png_append(scanline.data(), scanline.size());
+        else write(out, row_bytes);
+    }
+
+    void consume(const uint64_t *row) {
+        if (gray && block <= 64) {
+            // Bloc dans au plus deux mots voisins (bits au-dela de 'cells' a 0)
+            const uint64_t mask = block == 64 ? ~0ULL : (1ULL << block) - 1;
+            for (size_t j = 0, lo = 0; j < width_; ++j, lo += block) {
+                size_t w = lo >> 6, shift = lo & 63;
+                uint64_t bits = row[w] >> shift;
+                if (shift + block > 64 && w + 1 < words) bits |= row[w + 1] << (64 - shift);
+                counts[j] += __builtin_popcountll(bits & mask);
+            }
+        } else if (gray) {
+            for (size_t j = 0; j < width_; ++j)
+                counts[j] += static_cast<uint32_t>(packed_count(row, j * block, std::min(cells, (j + 1) * block)));
+        } else {
+            for (size_t w = 0; w < words; ++w) rows_or[w] |= row[w];
+        }
+        ++consumed;
+        if (consumed % block == 0 || consumed == rows) emit_scanline(consumed % block ? consumed % block : block);
+    }
+
+    void writer_loop() {
+        write_header();
+        for (;;) {
+            std::unique_lock<std::mutex> lock(mutex);
+            not_empty.wait(lock, [&] { return head != tail || closing; });
+            if (head == tail) break;
+            const uint64_t *row = queue[tail % QUEUE_ROWS].data();
+            lock.unlock();
+            consume(row);
+            lock.lock();
+            ++tail;
+            not_full.notify_one();
+        }
+        // Lignes manquantes : cellules a 0
+        std::vector<uint64_t> blank(words, 0);
+        while (consumed < rows) consume(blank.data());
+        write_trailer();
+    }
+
+    static bool ends_with(const std::string &s, const std::string &suffix) {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+public:
+    /**
+     * 'rows' lignes de 'cells' cellules (generation initiale comprise),
+     * reduites par blocs de 'block' x 'block'.
+     */
+    SpaceTimeRenderer(const std::string &path, size_t cells, size_t rows, size_t block = 1,
+                      Pooling pooling = Pooling::MAX)
+        : cells(cells), rows(rows), block(block ? block : 1), words((cells + 63) / 64), pooling(pooling),
+          png(ends_with(path, ".png")), gray(pooling == Pooling::AVERAGE && this->block > 1) {
+        width_ = (cells + this->block - 1) / this->block;
+        height_ = (rows + this->block - 1) / this->block;
+        row_bytes = gray ? width_ : (width_ + 7) / 8;
+        file = fopen(path.c_str(), "wb");
+        if (!file) {
+            failed = finished = true;
+            return;
+        }
+        setvbuf(file, nullptr, _IOFBF, 1 << 20);
+        queue.assign(QUEUE_ROWS, std::vector<uint64_t>(words));
+        scanline.resize(1 + row_bytes);
+        if (gray) counts.assign(width_, 0);
+        else rows_or.assign(words, 0);
+        writer = std::thread(&SpaceTimeRenderer::writer_loop, this);
+    }
+
+    SpaceTimeRenderer(const SpaceTimeRenderer &) = delete;
+    SpaceTimeRenderer &operator=(const SpaceTimeRenderer &) = delete;
+
+    ~SpaceTimeRenderer() { finish(); }
+
+    bool ok() const { return !failed; }
+    size_t width() const { return width_; }
+    size_t height() const { return height_; }
+    Pooling mode() const { return pooling; }
+
+    /**
+     * Depose la generation suivante (copie). Bloque seulement si le thread
+     * d'ecriture a QUEUE_ROWS lignes de retard.
+     */
+    void push(const uint64_t *row) {
+        if (finished || pushed >= rows) return;
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [&] { return head - tail < QUEUE_ROWS; });
+        std::vector<uint64_t> &slot = queue[head % QUEUE_ROWS];
+        lock.unlock();
+        std::copy(row, row + words, slot.begin());
+        if (words) slot[words - 1] &= (cells & 63) ? (1ULL << (cells & 63)) - 1 : ~0ULL;
+        lock.lock();
+        ++head;
+        ++pushed;
+        not_empty.notify_one();
+    }
+
+    void push(const PackedRing &row) { push(row.words.data()); }
+
+    /**
+     * Complete l'image, attend le thread d'ecriture et ferme le fichier.
+     * Renvoie false en cas d'erreur d'ecriture.
+     */
+    bool finish() {
+        if (finished) return ok();
+        finished = true;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+        }
+        not_empty.notify_one();
+        writer.join();
+        if (fclose(file) != 0) failed = true;
+        file = nullptr;
+        return ok();
+    }
+};
+
+#endif
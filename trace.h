@@ -0,0 +1,147 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// ==================== TRACE CHRONOLOGIQUE (Chrome Trace Event) ====================
+//
+// Spans nommes (minage, validation, Merkle, boucles de tests) enregistres dans
+// un tampon memoire par thread, puis ecrits a la fin du programme au format
+// Chrome Trace Event JSON (ouvrable dans Perfetto ou chrome://tracing).
+// Active a l'execution : AC_TRACE=trace.json ./build/Exercice4
+// Desactive (variable absente), un span se reduit a un test de booleen.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct TraceEvent {
+    const char *name;     // litteral : duree de vie statique
+    const char *argName;  // nullptr si pas d'argument
+    int64_t argValue;
+    uint64_t startNs;
+    uint64_t durationNs;
+};
+
+struct TraceBuffer {
+    uint32_t tid;
+    std::vector<TraceEvent> events;
+};
+
+class TraceSession {
+private:
+    std::mutex lock;
+    std::vector<std::unique_ptr<TraceBuffer>> buffers;
+    std::chrono::steady_clock::time_point origin;
+    std::string path;
+
+public:
+    std::atomic<bool> enabled{false};
+
+    TraceSession() : origin(std::chrono::steady_clock::now()) {
+        const char *env = getenv("AC_TRACE");
+        if (env && *env) {
+            path = env;
+            enabled.store(true, std::memory_order_relaxed);
+            atexit([] { trace_session().write(); });
+        }
+    }
+
+    static TraceSession &trace_session();
+
+    uint64_t nowNs() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin).count();
+    }
+
+    TraceBuffer &localBuffer() {
+        thread_local TraceBuffer *buffer = nullptr;
+        if (!buffer) {
+            std::lock_guard<std::mutex> guard(lock);
+            buffers.emplace_back(new TraceBuffer());
+            buffer = buffers.back().get();
+            buffer->tid = static_cast<uint32_t>(buffers.size());
+            buffer->events.reserve(4096);
+        }
+        return *buffer;
+    }
+
+    /**
+     * Ecrit tous les tampons en JSON (spans complets, phase "X")
+     */
+    bool write() {
+        if (path.empty()) return false;
+        FILE *f = fopen(path.c_str(), "w");
+        if (!f) return false;
+
+        std::lock_guard<std::mutex> guard(lock);
+        fprintf(f, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        bool first = true;
+        for (const auto &buffer : buffers) {
+            fprintf(f, "%s  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": \"thread %u\"}}",
+                    first ? "" : ",\n", buffer->tid, buffer->tid);
+            first = false;
+            for (const TraceEvent &e : buffer->events) {
+                fprintf(f, ",\n  {\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f",
+                        e.name, buffer->tid, e.startNs / 1000.0, e.durationNs / 1000.0);
+                if (e.argName)
+                    fprintf(f, ", \"args\": {\"%s\": %lld}", e.argName, (long long)e.argValue);
+                fprintf(f, "}");
+            }
+        }
+        fprintf(f, "\n]}\n");
+        fclose(f);
+        return true;
+    }
+};
+
+inline TraceSession &TraceSession::trace_session() {
+    static TraceSession *session = new TraceSession(); // encore valide dans le handler atexit
+    return *session;
+}
+
+inline TraceSession &trace_session() {
+    return TraceSession::trace_session();
+}
+
+/**
+ * Span RAII : enregistre [construction, destruction] dans le tampon du thread
+ */
+class TraceScope {
+private:
+    const char *name;
+    const char *argName;
+    int64_t argValue;
+    uint64_t start;
+    bool active;
+
+public:
+    explicit TraceScope(const char *n, const char *an = nullptr, int64_t av = 0)
+        : name(n), argName(an), argValue(av), start(0),
+          active(trace_session().enabled.load(std::memory_order_relaxed)) {
+        if (active) start = trace_session().nowNs();
+    }
+
+    ~TraceScope() { stop(); }
+
+    // Termine le span avant la fin du bloc (phases successives d'une fonction)
+    void stop() {
+        if (!active) return;
+        active = false;
+        TraceSession &session = trace_session();
+        uint64_t end = session.nowNs();
+        session.localBuffer().events.push_back({name, argName, argValue, start, end - start});
+    }
+};
+
+#define TRACE_CAT_(a, b) a##b
+#define TRACE_CAT(a, b) TRACE_CAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CAT(trace_scope_, __LINE__)(name)
+#define TRACE_SCOPE_ARG(name, argName, argValue) \
+    TraceScope TRACE_CAT(trace_scope_, __LINE__)(name, argName, static_cast<int64_t>(argValue))
+
+#endif